@@ -0,0 +1,24 @@
+#include "algo/binary.h"
+#include "benchmark_support/benchmark.h"
+
+using namespace au;
+using namespace au::benchmarks;
+
+static const size_t data_size = 16 * 1024 * 1024;
+
+static const auto unxor_byte = BenchmarkRegistration(
+    "algo/unxor/byte", []()
+    {
+        const auto input
+            = std::make_shared<bstr>(make_random_data(data_size, 1));
+        return Benchmark {data_size, [=]() { algo::unxor(*input, 0x5A); }};
+    });
+
+static const auto unxor_key = BenchmarkRegistration(
+    "algo/unxor/key", []()
+    {
+        const auto input
+            = std::make_shared<bstr>(make_random_data(data_size, 1));
+        const auto key = make_random_data(13, 2);
+        return Benchmark {data_size, [=]() { algo::unxor(*input, key); }};
+    });
@@ -0,0 +1,102 @@
+#include "algo/crypt/blowfish.h"
+#include "algo/crypt/lcg.h"
+#include "algo/crypt/md5.h"
+#include "algo/crypt/mt.h"
+#include "algo/crypt/rsa.h"
+#include "algo/range.h"
+#include "benchmark_support/benchmark.h"
+
+using namespace au;
+using namespace au::algo::crypt;
+using namespace au::benchmarks;
+
+static const size_t data_size = 4 * 1024 * 1024;
+static const size_t random_number_count = 1024 * 1024;
+
+static const auto md5_benchmark = BenchmarkRegistration(
+    "algo/crypt/md5", []()
+    {
+        const auto input
+            = std::make_shared<bstr>(make_random_data(data_size, 1));
+        return Benchmark {data_size, [=]() { md5(*input); }};
+    });
+
+static const auto blowfish_decrypt = BenchmarkRegistration(
+    "algo/crypt/blowfish/decrypt", []()
+    {
+        const auto blowfish
+            = std::make_shared<Blowfish>(make_random_data(16, 1));
+        const auto input
+            = std::make_shared<bstr>(make_random_data(data_size, 2));
+        return Benchmark {data_size, [=]() { blowfish->decrypt(*input); }};
+    });
+
+static const auto blowfish_encrypt = BenchmarkRegistration(
+    "algo/crypt/blowfish/encrypt", []()
+    {
+        const auto blowfish
+            = std::make_shared<Blowfish>(make_random_data(16, 1));
+        const auto input
+            = std::make_shared<bstr>(make_random_data(data_size, 2));
+        return Benchmark {data_size, [=]() { blowfish->encrypt(*input); }};
+    });
+
+static const auto mt = BenchmarkRegistration(
+    "algo/crypt/mt", []()
+    {
+        const auto generator = std::shared_ptr<MersenneTwister>(
+            MersenneTwister::Improved(1234));
+        return Benchmark {random_number_count * 4, [=]()
+        {
+            for (const auto i : algo::range(random_number_count))
+                generator->next_u32();
+        }};
+    });
+
+static const auto lcg = BenchmarkRegistration(
+    "algo/crypt/lcg", []()
+    {
+        const auto generator
+            = std::make_shared<Lcg>(LcgKind::MicrosoftVisualC, 1234);
+        return Benchmark {random_number_count * 4, [=]()
+        {
+            for (const auto i : algo::range(random_number_count))
+                generator->next();
+        }};
+    });
+
+static const auto rsa = BenchmarkRegistration(
+    "algo/crypt/rsa", []()
+    {
+        RsaKey key;
+        const auto modulus = make_random_data(key.modulus.size(), 1);
+        for (const auto i : algo::range(key.modulus.size()))
+            key.modulus[i] = modulus[i];
+        key.modulus.front() |= 0x80;
+        key.modulus.back() |= 1;
+        key.exponent = 65537;
+        const auto rsa = std::make_shared<Rsa>(key);
+
+        // made up blocks have no valid padding, but the padding is checked
+        // only after the expensive part
+        std::vector<bstr> blocks;
+        for (const auto i : algo::range(256))
+        {
+            auto block = make_random_data(key.modulus.size(), i + 2);
+            block[0] = 0;
+            blocks.push_back(block);
+        }
+        return Benchmark {blocks.size() * key.modulus.size(), [=]()
+        {
+            for (const auto &block : blocks)
+            {
+                try
+                {
+                    rsa->decrypt(block);
+                }
+                catch (...)
+                {
+                }
+            }
+        }};
+    });
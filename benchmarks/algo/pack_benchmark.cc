@@ -0,0 +1,162 @@
+#include "algo/pack/huffman.h"
+#include "algo/pack/lzss.h"
+#include "algo/pack/zlib.h"
+#include "algo/range.h"
+#include "benchmark_support/benchmark.h"
+
+using namespace au;
+using namespace au::algo::pack;
+using namespace au::benchmarks;
+
+static const size_t data_size = 4 * 1024 * 1024;
+
+namespace
+{
+    struct HuffmanCode final
+    {
+        u32 bits;
+        size_t size;
+    };
+
+    class BitWriter final
+    {
+    public:
+        void write(const size_t size, const u32 value);
+        bstr get();
+
+    private:
+        bstr output;
+        u32 buffer = 0;
+        size_t buffer_size = 0;
+    };
+}
+
+void BitWriter::write(const size_t size, const u32 value)
+{
+    for (const auto i : algo::range(size))
+    {
+        buffer = (buffer << 1) | ((value >> (size - 1 - i)) & 1);
+        if (++buffer_size == 8)
+        {
+            output += static_cast<u8>(buffer);
+            buffer = 0;
+            buffer_size = 0;
+        }
+    }
+}
+
+bstr BitWriter::get()
+{
+    if (buffer_size)
+        write(8 - buffer_size, 0);
+    return output;
+}
+
+// splits the symbols unevenly, so that the codes have different lengths
+static void write_huffman_tree(
+    BitWriter &writer,
+    std::vector<HuffmanCode> &codes,
+    const size_t first,
+    const size_t last,
+    const HuffmanCode prefix)
+{
+    if (last - first == 1)
+    {
+        writer.write(1, 0);
+        writer.write(8, first);
+        codes[first] = prefix;
+        return;
+    }
+    const auto middle = first + std::max<size_t>(1, (last - first) / 4);
+    writer.write(1, 1);
+    write_huffman_tree(
+        writer, codes, first, middle, {prefix.bits << 1, prefix.size + 1});
+    write_huffman_tree(
+        writer, codes, middle, last, {(prefix.bits << 1) | 1, prefix.size + 1});
+}
+
+static BitwiseLzssSettings get_bitwise_lzss_settings()
+{
+    BitwiseLzssSettings settings;
+    settings.position_bits = 12;
+    settings.size_bits = 4;
+    settings.min_match_size = 3;
+    settings.initial_dictionary_pos = 0xFEE;
+    return settings;
+}
+
+static const auto lzss_bitwise = BenchmarkRegistration(
+    "algo/pack/lzss_decompress/bitwise", []()
+    {
+        const auto settings = get_bitwise_lzss_settings();
+        const auto input = std::make_shared<bstr>(lzss_compress(
+            make_compressible_data(data_size, 1), settings));
+        return Benchmark {data_size, [=]()
+        {
+            lzss_decompress(*input, data_size, settings);
+        }};
+    });
+
+static const auto lzss_bytewise = BenchmarkRegistration(
+    "algo/pack/lzss_decompress/bytewise", []()
+    {
+        const auto input = std::make_shared<bstr>(
+            lzss_compress(make_compressible_data(data_size, 1)));
+        return Benchmark {data_size, [=]()
+        {
+            lzss_decompress(*input, data_size);
+        }};
+    });
+
+static const auto lzss_compress_bitwise = BenchmarkRegistration(
+    "algo/pack/lzss_compress/bitwise", []()
+    {
+        const auto settings = get_bitwise_lzss_settings();
+        const auto input = std::make_shared<bstr>(
+            make_compressible_data(data_size, 1));
+        return Benchmark {data_size, [=]()
+        {
+            lzss_compress(*input, settings);
+        }};
+    });
+
+static const auto lzss_compress_bytewise = BenchmarkRegistration(
+    "algo/pack/lzss_compress/bytewise", []()
+    {
+        const auto input = std::make_shared<bstr>(
+            make_compressible_data(data_size, 1));
+        return Benchmark {data_size, [=]()
+        {
+            lzss_compress(*input);
+        }};
+    });
+
+static const auto zlib = BenchmarkRegistration(
+    "algo/pack/zlib_inflate", []()
+    {
+        const auto input = std::make_shared<bstr>(
+            zlib_deflate(make_compressible_data(data_size, 1)));
+        return Benchmark {data_size, [=]()
+        {
+            zlib_inflate(*input, data_size);
+        }};
+    });
+
+static const auto huffman = BenchmarkRegistration(
+    "algo/pack/decode_huffman", []()
+    {
+        BitWriter tree_writer;
+        std::vector<HuffmanCode> codes(256);
+        write_huffman_tree(tree_writer, codes, 0, 256, {0, 0});
+        const auto tree = std::make_shared<HuffmanTree>(tree_writer.get());
+
+        BitWriter data_writer;
+        for (const u8 c : make_compressible_data(data_size, 1))
+            data_writer.write(codes[c].size, codes[c].bits);
+        const auto input = std::make_shared<bstr>(data_writer.get());
+
+        return Benchmark {data_size, [=]()
+        {
+            decode_huffman(*tree, *input, data_size);
+        }};
+    });
@@ -0,0 +1,183 @@
+#include "benchmark_support/benchmark.h"
+#include <chrono>
+#include <regex>
+#include "algo/format.h"
+#include "algo/range.h"
+#include "algo/str.h"
+#include "flow/allocation_tracker.h"
+#include "io/file.h"
+
+using namespace au;
+using namespace au::benchmarks;
+
+static std::map<std::string, BenchmarkFactory> &get_factories()
+{
+    static std::map<std::string, BenchmarkFactory> factories;
+    return factories;
+}
+
+static std::vector<BenchmarkGenerator> &get_generators()
+{
+    static std::vector<BenchmarkGenerator> generators;
+    return generators;
+}
+
+static bool matches(
+    const std::string &name, const std::vector<std::string> &filters)
+{
+    if (filters.empty())
+        return true;
+    for (const auto &filter : filters)
+        if (name.find(filter) != std::string::npos)
+            return true;
+    return false;
+}
+
+// xorshift32, which is enough for making up input data
+static u32 next_random(u32 &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(
+    const std::string &name, const BenchmarkFactory factory)
+{
+    get_factories()[name] = factory;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(
+    const BenchmarkGenerator generator)
+{
+    get_generators().push_back(generator);
+}
+
+double BenchmarkResult::get_ns_per_byte() const
+{
+    return seconds * 1e9 / std::max<double>(1, size * run_count);
+}
+
+void benchmarks::run_benchmarks(
+    const BenchmarkSettings &settings,
+    const std::function<void(const BenchmarkResult &)> on_result)
+{
+    auto factories = get_factories();
+    for (const auto &generator : get_generators())
+        for (const auto &kv : generator())
+            factories[kv.first] = kv.second;
+
+    for (const auto &kv : factories)
+    {
+        if (!matches(kv.first, settings.filters))
+            continue;
+
+        const auto benchmark = kv.second();
+        if (!benchmark.size)
+            continue;
+
+        BenchmarkResult result;
+        result.name = kv.first;
+        result.size = benchmark.size;
+        result.run_count = 0;
+
+        // the tracking has a cost of its own, so the allocations are counted
+        // in a run that also warms up the caches and isn't timed
+        {
+            flow::AllocationScope allocation_scope;
+            benchmark.run();
+            result.allocation_count
+                = allocation_scope.get_counters().allocation_count;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        do
+        {
+            benchmark.run();
+            ++result.run_count;
+            result.seconds = std::chrono::duration_cast<
+                std::chrono::duration<double>>(
+                    std::chrono::steady_clock::now() - start).count();
+        }
+        while (settings.run_count
+            ? result.run_count < settings.run_count
+            : result.seconds < settings.min_seconds);
+        on_result(result);
+    }
+}
+
+std::string benchmarks::format_result(const BenchmarkResult &result)
+{
+    return algo::format(
+        "{\"name\": \"%s\", \"size\": %llu, \"runs\": %llu, "
+        "\"seconds\": %.06f, \"mb_per_s\": %.03f, \"ns_per_byte\": %.04f, "
+        "\"allocations\": %llu}",
+        algo::escape_json(result.name).c_str(),
+        static_cast<unsigned long long>(result.size),
+        static_cast<unsigned long long>(result.run_count),
+        result.seconds,
+        1000.0 / result.get_ns_per_byte(),
+        result.get_ns_per_byte(),
+        static_cast<unsigned long long>(result.allocation_count));
+}
+
+std::map<std::string, double> benchmarks::read_baseline(const io::path &path)
+{
+    static const std::regex name_regex(
+        "\"name\": \"((?:[^\"\\\\]|\\\\.)*)\"");
+    static const std::regex value_regex("\"ns_per_byte\": ([0-9.eE+-]+)");
+    static const std::regex unescape_regex("\\\\(.)");
+
+    std::map<std::string, double> baseline;
+    io::File file(path, io::FileMode::Read);
+    const auto lines = algo::split(
+        file.stream.read_to_eof().str(), '\n', false);
+    for (const auto &line : lines)
+    {
+        std::smatch name_match, value_match;
+        if (!std::regex_search(line, name_match, name_regex))
+            continue;
+        if (!std::regex_search(line, value_match, value_regex))
+            continue;
+        const auto name = std::regex_replace(
+            name_match[1].str(), unescape_regex, "$1");
+        baseline[name] = std::stod(value_match[1]);
+    }
+    return baseline;
+}
+
+bstr benchmarks::make_random_data(const size_t size, const u32 seed)
+{
+    bstr output(size);
+    auto state = seed ? seed : 1;
+    for (const auto i : algo::range(size))
+        output[i] = next_random(state) >> 24;
+    return output;
+}
+
+// resembles text or scripts: short words repeating at random distances
+bstr benchmarks::make_compressible_data(const size_t size, const u32 seed)
+{
+    auto state = seed ? seed : 1;
+    std::vector<bstr> words;
+    for (const auto i : algo::range(256))
+    {
+        bstr word(2 + next_random(state) % 8);
+        for (auto &c : word)
+            c = 'a' + next_random(state) % 26;
+        words.push_back(word + " "_b);
+    }
+
+    bstr output;
+    output.reserve(size + 16);
+    while (output.size() < size)
+    {
+        // skewed, so that some words are much more common than others
+        const auto a = next_random(state) % words.size();
+        const auto b = next_random(state) % words.size();
+        output += words[std::min(a, b)];
+    }
+    output.resize(size);
+    return output;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "io/path.h"
+#include "types.h"
+
+namespace au {
+namespace benchmarks {
+
+    struct Benchmark final
+    {
+        // how many bytes a single run processes, for computing throughput
+        size_t size;
+
+        std::function<void()> run;
+    };
+
+    // Benchmarks prepare their input in the factory, so that it doesn't
+    // count towards the measured time. Benchmarks whose input turns out to
+    // be empty are skipped.
+    using BenchmarkFactory = std::function<Benchmark()>;
+
+    // for benchmarks that can only be listed once the program has started,
+    // such as ones for each of the registered decoders; generators run
+    // regardless of the filters, so the expensive work belongs in the
+    // factories
+    using BenchmarkGenerator
+        = std::function<std::map<std::string, BenchmarkFactory>()>;
+
+    struct BenchmarkRegistration final
+    {
+        BenchmarkRegistration(
+            const std::string &name, const BenchmarkFactory factory);
+        BenchmarkRegistration(const BenchmarkGenerator generator);
+    };
+
+    struct BenchmarkSettings final
+    {
+        // run the benchmarks whose names contain any of these, or all of
+        // them if empty
+        std::vector<std::string> filters;
+
+        // run each benchmark at least this long...
+        double min_seconds;
+
+        // ...or exactly this many times, if not zero
+        size_t run_count;
+    };
+
+    struct BenchmarkResult final
+    {
+        std::string name;
+        size_t size;
+        size_t run_count;
+
+        // allocations made by a single run
+        size_t allocation_count;
+
+        double seconds;
+
+        double get_ns_per_byte() const;
+    };
+
+    void run_benchmarks(
+        const BenchmarkSettings &settings,
+        const std::function<void(const BenchmarkResult &)> on_result);
+
+    // a single line of JSON
+    std::string format_result(const BenchmarkResult &result);
+
+    // reads ns_per_byte of each benchmark from the output of an earlier run
+    std::map<std::string, double> read_baseline(const io::path &path);
+
+    // the same for each call with the same arguments
+    bstr make_random_data(const size_t size, const u32 seed);
+    bstr make_compressible_data(const size_t size, const u32 seed);
+
+} }
@@ -0,0 +1,191 @@
+#include <iostream>
+#include "algo/format.h"
+#include "algo/str.h"
+#include "benchmark_support/benchmark.h"
+#include "dec/decoder_pool.h"
+#include "dec/idecoder_visitor.h"
+#include "dec/registry.h"
+#include "io/file_system.h"
+#include "logger.h"
+
+using namespace au;
+using namespace au::benchmarks;
+
+// the sample files used by the decoder tests
+static const io::path corpus_directory = "tests/dec";
+
+namespace
+{
+    struct CorpusFile final
+    {
+        io::path path;
+        bstr data;
+    };
+
+    // decodes everything there is to decode, without saving anything
+    class FullDecodeVisitor final : public dec::IDecoderVisitor
+    {
+    public:
+        FullDecodeVisitor(const Logger &logger, io::File &input_file);
+
+        void visit(const dec::BaseArchiveDecoder &decoder) override;
+        void visit(const dec::BaseFileDecoder &decoder) override;
+        void visit(const dec::BaseImageDecoder &decoder) override;
+        void visit(const dec::BaseAudioDecoder &decoder) override;
+
+    private:
+        const Logger &logger;
+        io::File &input_file;
+    };
+}
+
+FullDecodeVisitor::FullDecodeVisitor(
+    const Logger &logger, io::File &input_file)
+    : logger(logger), input_file(input_file)
+{
+}
+
+void FullDecodeVisitor::visit(const dec::BaseArchiveDecoder &decoder)
+{
+    const auto meta = decoder.read_meta(logger, input_file);
+    for (const auto &entry : meta->entries)
+        decoder.read_file(logger, input_file, *meta, *entry);
+}
+
+void FullDecodeVisitor::visit(const dec::BaseFileDecoder &decoder)
+{
+    decoder.decode(logger, input_file);
+}
+
+void FullDecodeVisitor::visit(const dec::BaseImageDecoder &decoder)
+{
+    decoder.decode(logger, input_file);
+}
+
+void FullDecodeVisitor::visit(const dec::BaseAudioDecoder &decoder)
+{
+    decoder.decode(logger, input_file);
+}
+
+static void recognize_and_decode(
+    const Logger &logger, const dec::IDecoder &decoder, const CorpusFile &file)
+{
+    io::File input_file(file.path, file.data);
+    if (!decoder.is_recognized(input_file))
+        throw std::logic_error("File not recognized: " + file.path.str());
+    input_file.stream.seek(0);
+    FullDecodeVisitor visitor(logger, input_file);
+    decoder.accept(visitor);
+}
+
+// Sample files are stored as tests/dec/<group>/files/..., where the group
+// matches the part of decoder names before the slash. Within the group,
+// a file belongs to the decoder that recognizes it, as long as it is the
+// only one. Files that need options to decode, such as keys, are left out.
+static std::map<std::string, std::vector<CorpusFile>> collect_corpus(
+    const Logger &logger,
+    dec::DecoderPool &decoder_pool,
+    const io::path &files_path,
+    const std::set<std::string> &decoder_names)
+{
+    const auto &registry = dec::Registry::instance();
+    std::map<std::string, std::vector<CorpusFile>> corpus;
+    for (const auto &path : io::recursive_directory_range(files_path))
+    {
+        if (io::is_directory(path))
+            continue;
+        CorpusFile file;
+        file.path = path;
+        file.data = io::File(path, io::FileMode::Read).stream.read_to_eof();
+
+        io::File input_file(file.path, file.data);
+        std::vector<std::string> matching_names;
+        for (const auto &name : registry.get_plausible_decoder_names(
+            input_file, decoder_names))
+        {
+            input_file.stream.seek(0);
+            try
+            {
+                if (decoder_pool.get_decoder(name)->is_recognized(input_file))
+                    matching_names.push_back(name);
+            }
+            catch (...)
+            {
+            }
+        }
+        if (matching_names.size() != 1)
+            continue;
+
+        try
+        {
+            const auto decoder = decoder_pool.get_decoder(matching_names[0]);
+            recognize_and_decode(logger, *decoder, file);
+        }
+        catch (...)
+        {
+            continue;
+        }
+        corpus[matching_names[0]].push_back(file);
+    }
+    return corpus;
+}
+
+// Only the benchmark names are listed up front. The files of a group are
+// read and sorted out by the first of its benchmarks that gets to run, so
+// that runs filtered to other benchmarks don't pay for it.
+static const auto corpus_benchmarks = BenchmarkRegistration([]()
+{
+    std::map<std::string, BenchmarkFactory> factories;
+    if (!io::is_directory(corpus_directory))
+    {
+        std::cerr << algo::format(
+            "Warning: %s not found, skipping decoder benchmarks. "
+            "Run the benchmarks from the repository root.\n",
+            corpus_directory.c_str());
+        return factories;
+    }
+
+    const auto &registry = dec::Registry::instance();
+    const auto logger = std::make_shared<Logger>();
+    logger->mute();
+    const auto decoder_pool = std::make_shared<dec::DecoderPool>(
+        registry, std::vector<std::string>());
+
+    for (const auto &group_path : io::directory_range(corpus_directory))
+    {
+        const auto files_path = group_path / "files";
+        if (!io::is_directory(files_path))
+            continue;
+
+        const auto group = algo::replace_all(group_path.name(), "_", "-");
+        std::set<std::string> decoder_names;
+        for (const auto &name : registry.get_decoder_names())
+            if (name.find(group + "/") == 0)
+                decoder_names.insert(name);
+
+        using Corpus = std::map<std::string, std::vector<CorpusFile>>;
+        const auto corpus = std::make_shared<std::unique_ptr<Corpus>>();
+        for (const auto &name : decoder_names)
+        {
+            factories["dec/" + name] = [=]()
+            {
+                if (!*corpus)
+                {
+                    *corpus = std::make_unique<Corpus>(collect_corpus(
+                        *logger, *decoder_pool, files_path, decoder_names));
+                }
+                const auto decoder = decoder_pool->get_decoder(name);
+                const auto files = (**corpus)[name];
+                size_t size = 0;
+                for (const auto &file : files)
+                    size += file.data.size();
+                return Benchmark {size, [=]()
+                {
+                    for (const auto &file : files)
+                        recognize_and_decode(*logger, *decoder, file);
+                }};
+            };
+        }
+    }
+    return factories;
+});
@@ -0,0 +1,81 @@
+#include "algo/range.h"
+#include "benchmark_support/benchmark.h"
+#include "io/bit_reader.h"
+#include "io/lsb_bit_stream.h"
+#include "io/memory_stream.h"
+#include "io/msb_bit_stream.h"
+
+using namespace au;
+using namespace au::benchmarks;
+
+static const size_t data_size = 4 * 1024 * 1024;
+
+// keeps the compiler from dropping the reads
+static volatile u32 sink;
+
+// mixes the widths typical for LZSS and Huffman decoders
+template<typename T> static void read_all(T &reader)
+{
+    static const size_t widths[] = {1, 8, 1, 12, 4, 1, 1, 8, 3, 9};
+    u32 sum = 0;
+    size_t bits_left = data_size * 8;
+    while (true)
+    {
+        for (const auto width : widths)
+        {
+            if (bits_left < width)
+            {
+                sink = sum;
+                return;
+            }
+            sum += reader.read(width);
+            bits_left -= width;
+        }
+    }
+}
+
+template<io::BitOrder order> static Benchmark make_bit_reader_benchmark()
+{
+    const auto input = std::make_shared<bstr>(make_random_data(data_size, 1));
+    return Benchmark {data_size, [=]()
+    {
+        io::BitReader<order> reader(input->get<u8>(), input->size());
+        read_all(reader);
+    }};
+}
+
+template<typename T> static Benchmark make_bit_stream_benchmark()
+{
+    const auto input = std::make_shared<bstr>(make_random_data(data_size, 1));
+    return Benchmark {data_size, [=]()
+    {
+        T bit_stream(*input);
+        read_all<io::BaseBitStream>(bit_stream);
+    }};
+}
+
+static const auto bit_reader_msb = BenchmarkRegistration(
+    "io/bit_reader/msb", make_bit_reader_benchmark<io::BitOrder::Msb>);
+
+static const auto bit_reader_lsb = BenchmarkRegistration(
+    "io/bit_reader/lsb", make_bit_reader_benchmark<io::BitOrder::Lsb>);
+
+static const auto msb_bit_stream = BenchmarkRegistration(
+    "io/msb_bit_stream", make_bit_stream_benchmark<io::MsbBitStream>);
+
+static const auto lsb_bit_stream = BenchmarkRegistration(
+    "io/lsb_bit_stream", make_bit_stream_benchmark<io::LsbBitStream>);
+
+// bit streams attached to a byte stream still fetch one byte at a time
+static const auto msb_bit_stream_over_byte_stream = BenchmarkRegistration(
+    "io/msb_bit_stream/byte_stream", []()
+    {
+        const auto input
+            = std::make_shared<bstr>(make_random_data(data_size, 1));
+        return Benchmark {data_size, [=]()
+        {
+            io::MemoryStream byte_stream(*input);
+            io::MsbBitStream bit_stream(byte_stream);
+            read_all<io::BaseBitStream>(bit_stream);
+        }};
+    });
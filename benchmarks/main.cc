@@ -0,0 +1,100 @@
+#include <iostream>
+#include "algo/format.h"
+#include "algo/str.h"
+#include "benchmark_support/benchmark.h"
+#include "entry_point.h"
+#include "io/program_path.h"
+
+using namespace au;
+
+static bool get_option(
+    const std::string &argument, const std::string &name, std::string &value)
+{
+    const auto prefix = name + "=";
+    if (argument.find(prefix) != 0)
+        return false;
+    value = argument.substr(prefix.size());
+    return true;
+}
+
+// Prints one JSON object per line, so that the output can be used as the
+// baseline of later runs. Arguments other than the options below select
+// the benchmarks to run by their names.
+//
+// --min-time=SECONDS  run each benchmark at least this long (0.5)
+// --runs=N            run each benchmark exactly N times instead
+// --baseline=PATH     compare with the output of an earlier run
+// --threshold=PERCENT slowdown reported as a regression (10)
+static int run(std::vector<std::string> arguments)
+{
+    io::set_program_path_from_arg(arguments[0]);
+    arguments.erase(arguments.begin());
+
+    benchmarks::BenchmarkSettings settings;
+    settings.min_seconds = 0.5;
+    settings.run_count = 0;
+    io::path baseline_path;
+    double threshold = 10;
+    for (const auto &argument : arguments)
+    {
+        std::string value;
+        if (get_option(argument, "--min-time", value))
+            settings.min_seconds = algo::from_string<float>(value);
+        else if (get_option(argument, "--runs", value))
+            settings.run_count = algo::from_string<int>(value);
+        else if (get_option(argument, "--baseline", value))
+            baseline_path = value;
+        else if (get_option(argument, "--threshold", value))
+            threshold = algo::from_string<float>(value);
+        else
+            settings.filters.push_back(argument);
+    }
+
+    const auto baseline = baseline_path.str().empty()
+        ? std::map<std::string, double>()
+        : benchmarks::read_baseline(baseline_path);
+
+    size_t regression_count = 0;
+    benchmarks::run_benchmarks(
+        settings,
+        [&](const benchmarks::BenchmarkResult &result)
+        {
+            std::cout << benchmarks::format_result(result) << std::endl;
+            const auto it = baseline.find(result.name);
+            if (it == baseline.end())
+                return;
+            const auto change
+                = (result.get_ns_per_byte() / it->second - 1) * 100;
+            if (change <= threshold)
+                return;
+            ++regression_count;
+            std::cerr << algo::format(
+                "Regression: %s is %.01f%% slower (%.04f ns/byte, was %.04f)\n",
+                result.name.c_str(),
+                change,
+                result.get_ns_per_byte(),
+                it->second);
+        });
+
+    if (regression_count)
+    {
+        std::cerr << algo::format(
+            "%d regression%s\n",
+            static_cast<int>(regression_count),
+            regression_count == 1 ? "" : "s");
+        return 1;
+    }
+    return 0;
+}
+
+ENTRY_POINT(
+    try
+    {
+        return run(arguments);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+)
@@ -0,0 +1,66 @@
+#include "algo/range.h"
+#include "benchmark_support/benchmark.h"
+#include "res/pixel_format.h"
+
+using namespace au;
+using namespace au::benchmarks;
+
+static const size_t pixel_count = 1024 * 1024;
+
+namespace
+{
+    struct PixelFormatBenchmarks final
+    {
+        PixelFormatBenchmarks();
+        std::vector<BenchmarkRegistration> registrations;
+    };
+}
+
+static const std::vector<std::pair<res::PixelFormat, std::string>> formats
+{
+    {res::PixelFormat::Gray8, "Gray8"},
+    {res::PixelFormat::BGR555X, "BGR555X"},
+    {res::PixelFormat::BGR565, "BGR565"},
+    {res::PixelFormat::BGR888, "BGR888"},
+    {res::PixelFormat::BGR888X, "BGR888X"},
+    {res::PixelFormat::BGRA4444, "BGRA4444"},
+    {res::PixelFormat::BGRA5551, "BGRA5551"},
+    {res::PixelFormat::BGRA8888, "BGRA8888"},
+    {res::PixelFormat::BGRnA4444, "BGRnA4444"},
+    {res::PixelFormat::BGRnA5551, "BGRnA5551"},
+    {res::PixelFormat::BGRnA8888, "BGRnA8888"},
+    {res::PixelFormat::RGB555X, "RGB555X"},
+    {res::PixelFormat::RGB565, "RGB565"},
+    {res::PixelFormat::RGB888, "RGB888"},
+    {res::PixelFormat::RGB888X, "RGB888X"},
+    {res::PixelFormat::RGBA4444, "RGBA4444"},
+    {res::PixelFormat::RGBA5551, "RGBA5551"},
+    {res::PixelFormat::RGBA8888, "RGBA8888"},
+    {res::PixelFormat::RGBnA4444, "RGBnA4444"},
+    {res::PixelFormat::RGBnA5551, "RGBnA5551"},
+    {res::PixelFormat::RGBnA8888, "RGBnA8888"},
+};
+
+PixelFormatBenchmarks::PixelFormatBenchmarks()
+{
+    for (const auto &kv : formats)
+    {
+        const auto format = kv.first;
+        registrations.emplace_back(
+            "res/read_pixels/" + kv.second, [format]()
+            {
+                const auto size
+                    = pixel_count * res::pixel_format_to_bpp(format);
+                const auto input
+                    = std::make_shared<bstr>(make_random_data(size, 1));
+                const auto output
+                    = std::make_shared<std::vector<res::Pixel>>(pixel_count);
+                return Benchmark {size, [=]()
+                {
+                    res::read_pixels(input->get<const u8>(), *output, format);
+                }};
+            });
+    }
+}
+
+static const PixelFormatBenchmarks pixel_format_benchmarks;
@@ -2,74 +2,201 @@
 #include <cerrno>
 #include <iconv.h>
 #include <memory>
+#include "algo/range.h"
 #include "err.h"
 
 using namespace au;
 
-static bstr convert_locale(
-    const bstr &input, const std::string &from, const std::string &to)
+namespace
+{
+    enum class Conversion : u8
+    {
+        SjisToUtf8 = 0,
+        Utf16ToUtf8 = 1,
+        Utf8ToSjis = 2,
+        Utf8ToUtf16 = 3,
+    };
+
+    // iconv_open() is expensive, so every thread keeps its descriptors for
+    // as long as it lives
+    class IconvCache final
+    {
+    public:
+        IconvCache();
+        ~IconvCache();
+
+        iconv_t get(const Conversion conversion);
+
+    private:
+        iconv_t descriptors[4];
+    };
+}
+
+static thread_local IconvCache iconv_cache;
+
+IconvCache::IconvCache()
+{
+    for (auto &descriptor : descriptors)
+        descriptor = reinterpret_cast<iconv_t>(-1);
+}
+
+IconvCache::~IconvCache()
+{
+    for (auto &descriptor : descriptors)
+        if (descriptor != reinterpret_cast<iconv_t>(-1))
+            iconv_close(descriptor);
+}
+
+iconv_t IconvCache::get(const Conversion conversion)
 {
-    iconv_t conv = iconv_open(to.c_str(), from.c_str());
-    if (!conv)
-        throw std::logic_error("Failed to initialize iconv");
+    static const char *const names[][2] =
+    {
+        {"cp932", "utf-8"},
+        {"utf-16le", "utf-8"},
+        {"utf-8", "cp932"},
+        {"utf-8", "utf-16le"},
+    };
+
+    auto &descriptor = descriptors[static_cast<size_t>(conversion)];
+    if (descriptor == reinterpret_cast<iconv_t>(-1))
+    {
+        const auto &name = names[static_cast<size_t>(conversion)];
+        descriptor = iconv_open(name[1], name[0]);
+        if (descriptor == reinterpret_cast<iconv_t>(-1))
+            throw std::logic_error("Failed to initialize iconv");
+    }
+    else
+    {
+        // clear the shift state left by the previous conversion
+        iconv(descriptor, nullptr, nullptr, nullptr, nullptr);
+    }
+    return descriptor;
+}
 
-    bstr output;
-    output.reserve(input.size() * 2);
+static bstr convert_locale(
+    const bstr &input,
+    const Conversion conversion,
+    const size_t max_output_bytes_per_input_byte)
+{
+    const auto conv = iconv_cache.get(conversion);
 
+    // the buffer is sized for the worst case, so a single call is enough
+    // for any valid input
+    bstr output(input.size() * max_output_bytes_per_input_byte);
     char *input_ptr = const_cast<char*>(input.get<const char>());
+    char *output_ptr = output.get<char>();
     size_t input_bytes_left = input.size();
-    bstr buffer(32);
+    size_t output_bytes_left = output.size();
 
     while (true)
     {
-        char *output_buffer = buffer.get<char>();
-        size_t output_bytes_left = buffer.size();
-        int ret = iconv(
+        const auto ret = iconv(
             conv,
             &input_ptr,
             &input_bytes_left,
-            &output_buffer,
+            &output_ptr,
             &output_bytes_left);
         const auto err = errno;
 
-        output += buffer.substr(0, buffer.size() - output_bytes_left);
-
-        if (ret != -1 && input_bytes_left == 0)
+        if (ret != static_cast<size_t>(-1) && input_bytes_left == 0)
             break;
 
-        // repeat the iteration unless nothing was parsed at all
-        if (err == E2BIG && output_bytes_left != buffer.size())
-            continue;
-
-        iconv_close(conv);
         if (err == E2BIG)
-            throw err::CorruptDataError("Code point too large to decode (?)");
+        {
+            const auto output_pos = output_ptr - output.get<char>();
+            output.resize(output.size() * 2 + 4);
+            output_ptr = output.get<char>() + output_pos;
+            output_bytes_left = output.size() - output_pos;
+            continue;
+        }
         else if (err == EINVAL || err == EILSEQ)
             throw err::CorruptDataError("Invalid byte sequence");
         else
             throw err::CorruptDataError("Unknown iconv error");
     }
 
-    iconv_close(conv);
+    output.resize(output_ptr - output.get<char>());
     return output;
 }
 
+static bool is_ascii(const bstr &input)
+{
+    for (const auto c : input)
+        if (c & 0x80)
+            return false;
+    return true;
+}
+
 bstr algo::sjis_to_utf8(const bstr &input)
 {
-    return convert_locale(input, "cp932", "utf-8");
+    // ASCII and half-width katakana map to Unicode without a table, which
+    // covers most of file names
+    size_t output_size = 0;
+    for (const auto c : input)
+    {
+        if (c < 0x80)
+            output_size += 1;
+        else if (c >= 0xA1 && c <= 0xDF)
+            output_size += 3;
+        else
+            return convert_locale(input, Conversion::SjisToUtf8, 3);
+    }
+    if (output_size == input.size())
+        return input;
+
+    bstr output(output_size);
+    auto output_ptr = output.get<u8>();
+    for (const auto c : input)
+    {
+        if (c < 0x80)
+        {
+            *output_ptr++ = c;
+        }
+        else
+        {
+            // U+FF61..U+FF9F
+            const u16 code_point = 0xFF61 + (c - 0xA1);
+            *output_ptr++ = 0xE0 | (code_point >> 12);
+            *output_ptr++ = 0x80 | ((code_point >> 6) & 0x3F);
+            *output_ptr++ = 0x80 | (code_point & 0x3F);
+        }
+    }
+    return output;
 }
 
 bstr algo::utf16_to_utf8(const bstr &input)
 {
-    return convert_locale(input, "utf-16le", "utf-8");
+    if (input.size() % 2 == 0)
+    {
+        bool ascii = true;
+        for (const auto i : algo::range(0, input.size(), 2))
+            ascii &= input[i] < 0x80 && !input[i + 1];
+        if (ascii)
+        {
+            bstr output(input.size() / 2);
+            for (const auto i : algo::range(output.size()))
+                output[i] = input[i * 2];
+            return output;
+        }
+    }
+    return convert_locale(input, Conversion::Utf16ToUtf8, 2);
 }
 
 bstr algo::utf8_to_sjis(const bstr &input)
 {
-    return convert_locale(input, "utf-8", "cp932");
+    if (is_ascii(input))
+        return input;
+    return convert_locale(input, Conversion::Utf8ToSjis, 1);
 }
 
 bstr algo::utf8_to_utf16(const bstr &input)
 {
-    return convert_locale(input, "utf-8", "utf-16le");
+    if (is_ascii(input))
+    {
+        bstr output(input.size() * 2);
+        for (const auto i : algo::range(input.size()))
+            output[i * 2] = input[i];
+        return output;
+    }
+    return convert_locale(input, Conversion::Utf8ToUtf16, 2);
 }
@@ -1,11 +1,154 @@
 #include "algo/pack/huffman.h"
+#include <algorithm>
+#include <vector>
+#include "algo/range.h"
 #include "io/msb_bit_stream.h"
 
 using namespace au;
 using namespace au::algo::pack;
 
-static int init_huffman_impl(
-    io::BaseBitStream &input_stream, u16 nodes[2][512], int &size)
+// most codes of byte-oriented trees fit in the primary table, which is
+// still small enough to be cheap to build
+static const size_t max_table_bits = 10;
+
+// below this many symbols, building the tables takes longer than walking
+// the tree bit by bit
+static const size_t min_table_output_size = 512;
+
+namespace
+{
+    // One entry of the lookup tables that map the next few bits of the
+    // input to a symbol. Codes that are too long for a table continue in
+    // the table the entry links to.
+    struct TableEntry final
+    {
+        // symbol, or offset of the linked table
+        u32 value;
+
+        // how many bits the code takes, or how many bits the linked table
+        // is indexed with
+        u8 size;
+
+        bool is_link;
+    };
+
+    // Lookup tables indexed with up to max_table_bits, the primary one
+    // going first. Linked tables are sized after the subtrees they cover.
+    struct HuffmanTable final
+    {
+        HuffmanTable(const HuffmanTree &tree);
+
+        std::vector<TableEntry> entries;
+        size_t bits;
+
+    private:
+        void measure(const u16 node);
+        size_t get_table_bits(const u16 node, const bool primary) const;
+        void fill(
+            const u16 node,
+            const size_t code,
+            const size_t code_size,
+            const size_t offset,
+            const size_t bits);
+
+        const HuffmanTree &tree;
+
+        // for the inner nodes, indexed from 256
+        size_t depths[256];
+        size_t leaf_counts[256];
+    };
+}
+
+static bool is_leaf(const u16 node)
+{
+    return node < 256 || node > 511;
+}
+
+HuffmanTable::HuffmanTable(const HuffmanTree &tree) : tree(tree)
+{
+    if (!is_leaf(tree.root))
+        measure(tree.root);
+    bits = get_table_bits(tree.root, true);
+    entries.resize(1 << bits);
+    fill(tree.root, 0, 0, 0, bits);
+}
+
+void HuffmanTable::measure(const u16 node)
+{
+    auto &depth = depths[node - 256];
+    auto &leaf_count = leaf_counts[node - 256];
+    depth = 0;
+    leaf_count = 0;
+    for (const auto bit : {0, 1})
+    {
+        const auto child = tree.nodes[bit][node];
+        if (is_leaf(child))
+        {
+            depth = std::max<size_t>(depth, 1);
+            leaf_count++;
+            continue;
+        }
+        measure(child);
+        depth = std::max(depth, depths[child - 256] + 1);
+        leaf_count += leaf_counts[child - 256];
+    }
+}
+
+size_t HuffmanTable::get_table_bits(const u16 node, const bool primary) const
+{
+    if (is_leaf(node))
+        return 0;
+    // deep subtrees with few leaves, which are common for the rare
+    // symbols, would mostly fill their tables with copies of short codes
+    size_t bits = 1;
+    while (!primary && (1u << bits) < leaf_counts[node - 256])
+        bits++;
+    return std::min(
+        {primary ? max_table_bits : bits, depths[node - 256], max_table_bits});
+}
+
+// fills the table at the given offset with the codes of the subtree, which
+// are prefixed with the code of its root
+void HuffmanTable::fill(
+    const u16 node,
+    const size_t code,
+    const size_t code_size,
+    const size_t offset,
+    const size_t bits)
+{
+    if (is_leaf(node))
+    {
+        const auto shift = bits - code_size;
+        const TableEntry entry = {node, static_cast<u8>(code_size), false};
+        std::fill_n(
+            entries.begin() + offset + (code << shift), 1 << shift, entry);
+        return;
+    }
+
+    if (code_size == bits)
+    {
+        const auto link_bits = get_table_bits(node, false);
+        const auto link_offset = entries.size();
+        entries.resize(link_offset + (1 << link_bits));
+        entries[offset + code] = {
+            static_cast<u32>(link_offset), static_cast<u8>(link_bits), true};
+        fill(node, 0, 0, link_offset, link_bits);
+        return;
+    }
+
+    for (const auto bit : {0, 1})
+    {
+        fill(
+            tree.nodes[bit][node],
+            (code << 1) | bit,
+            code_size + 1,
+            offset,
+            bits);
+    }
+}
+
+template<typename T> static int init_huffman_impl(
+    T &input_stream, u16 nodes[2][512], int &size)
 {
     if (!input_stream.read(1))
         return input_stream.read(8);
@@ -18,12 +161,67 @@ static int init_huffman_impl(
     return pos;
 }
 
+// Both decoders work on a copy of the reader: writing the output through
+// a byte pointer would otherwise force the compiler to reload its state.
+static size_t decode_with_tree(
+    const HuffmanTree &tree,
+    io::BitReader<io::BitOrder::Msb> &input_reader,
+    u8 *output,
+    const size_t output_size)
+{
+    auto reader = input_reader;
+    size_t i = 0;
+    while (i < output_size && !reader.eof())
+    {
+        auto node = tree.root;
+        while (!is_leaf(node))
+            node = tree.nodes[reader.read(1)][node];
+        output[i++] = node;
+    }
+    input_reader = reader;
+    return i;
+}
+
+static size_t decode_with_table(
+    const HuffmanTable &table,
+    io::BitReader<io::BitOrder::Msb> &input_reader,
+    u8 *output,
+    const size_t output_size)
+{
+    const auto entries = table.entries.data();
+    auto reader = input_reader;
+    size_t i = 0;
+    while (i < output_size && !reader.eof())
+    {
+        reader.refill();
+        auto bits = table.bits;
+        auto entry = entries[reader.peek(bits)];
+        while (entry.is_link)
+        {
+            reader.consume(bits);
+            reader.refill();
+            bits = entry.size;
+            entry = entries[entry.value + reader.peek(bits)];
+        }
+        reader.consume(entry.size);
+        output[i++] = entry.value;
+    }
+    input_reader = reader;
+    return i;
+}
+
 HuffmanTree::HuffmanTree(io::BaseBitStream &input_stream)
 {
     size = 256;
     root = init_huffman_impl(input_stream, nodes, size);
 }
 
+HuffmanTree::HuffmanTree(io::BitReader<io::BitOrder::Msb> &input_reader)
+{
+    size = 256;
+    root = init_huffman_impl(input_reader, nodes, size);
+}
+
 HuffmanTree::HuffmanTree(const bstr &data)
 {
     io::MsbBitStream input_stream(data);
@@ -31,20 +229,30 @@ HuffmanTree::HuffmanTree(const bstr &data)
     root = init_huffman_impl(input_stream, nodes, size);
 }
 
+size_t algo::pack::decode_huffman(
+    const HuffmanTree &huffman_tree,
+    io::BitReader<io::BitOrder::Msb> &input_reader,
+    u8 *output,
+    const size_t output_size)
+{
+    if (output_size < min_table_output_size)
+    {
+        return decode_with_tree(
+            huffman_tree, input_reader, output, output_size);
+    }
+    const HuffmanTable table(huffman_tree);
+    return decode_with_table(table, input_reader, output, output_size);
+}
+
 bstr algo::pack::decode_huffman(
     const HuffmanTree &huffman_tree,
     const bstr &input,
     const size_t target_size)
 {
-    bstr output;
-    output.resize(target_size);
-    io::MsbBitStream input_stream(input);
-    while (output.size() < target_size && !input_stream.eof())
-    {
-        auto byte = huffman_tree.root;
-        while (byte >= 256 && byte <= 511)
-            byte = huffman_tree.nodes[input_stream.read(1)][byte];
-        output += static_cast<const u8>(byte);
-    }
+    bstr output(target_size);
+    io::BitReader<io::BitOrder::Msb> input_reader(
+        input.get<u8>(), input.size());
+    output.resize(decode_huffman(
+        huffman_tree, input_reader, output.get<u8>(), output.size()));
     return output;
 }
@@ -1,15 +1,19 @@
 #pragma once
 
 #include "io/base_bit_stream.h"
+#include "io/bit_reader.h"
 
 namespace au {
 namespace algo {
 namespace pack {
 
+    // Tree of byte symbols stored as a preorder bit sequence: 1 followed by
+    // both subtrees for inner nodes, 0 followed by 8 bits for leaves.
     struct HuffmanTree final
     {
         HuffmanTree(const bstr &data);
         HuffmanTree(io::BaseBitStream &input_stream);
+        HuffmanTree(io::BitReader<io::BitOrder::Msb> &input_reader);
 
         int size;
         u16 root;
@@ -21,4 +25,12 @@ namespace pack {
         const bstr &input,
         const size_t target_size);
 
+    // Decodes until the output is full or the input ends, and returns how
+    // many symbols were decoded. On errors, the reader stays unchanged.
+    size_t decode_huffman(
+        const HuffmanTree &huffman_tree,
+        io::BitReader<io::BitOrder::Msb> &input_reader,
+        u8 *output,
+        const size_t output_size);
+
 } } }
@@ -1,7 +1,8 @@
 #include "algo/pack/lzss.h"
-#include <array>
-#include "algo/ptr.h"
+#include <algorithm>
+#include <cstring>
 #include "algo/range.h"
+#include "io/bit_reader.h"
 #include "io/memory_stream.h"
 #include "io/msb_bit_stream.h"
 
@@ -9,21 +10,40 @@ using namespace au;
 
 namespace
 {
-    struct LzssEncoderState final
+    struct LzssMatch final
     {
-        LzssEncoderState(const size_t dict_size, const size_t max_match_size);
+        size_t size;
+        size_t distance;
+    };
 
-        void insert_node(int r);
-        void delete_node(int p);
+    // Finds the longest earlier occurrence of the data at a given position
+    // by following a chain of the previous positions whose first bytes hash
+    // the same. The chains are kept for one window of positions only.
+    class LzssMatchFinder final
+    {
+    public:
+        LzssMatchFinder(
+            const bstr &data,
+            const size_t window_size,
+            const size_t min_match_size,
+            const size_t max_match_size,
+            const size_t max_chain_length);
 
-        const size_t dict_size;
-        const size_t max_match_size;
-        const int empty;
-        std::vector<u8> text_buf;
-        std::vector<int> children[2], dad;
+        void insert(const size_t pos);
+        LzssMatch find(const size_t pos) const;
 
-        size_t match_position;
-        size_t match_size;
+    private:
+        size_t hash(const size_t pos) const;
+
+        const u8 *data;
+        const size_t data_size;
+        const size_t window_size;
+        const size_t min_match_size;
+        const size_t max_match_size;
+        const size_t max_chain_length;
+        const size_t hash_size;
+        std::vector<u32> head;
+        std::vector<u32> prev;
     };
 
     class BaseLzssWriter
@@ -154,291 +174,417 @@ algo::pack::BytewiseLzssSettings::BytewiseLzssSettings()
 {
 }
 
-bstr algo::pack::lzss_decompress(
-    const bstr &input,
-    const size_t output_size,
-    const BitwiseLzssSettings &settings)
+// Matches are copied chunk by chunk when the source is far enough behind,
+// which may write up to this many bytes past their end.
+static const size_t copy_slack = 16;
+
+// Converts a dictionary position to how many bytes back in the output the
+// match starts. The dictionary always holds the most recent output, with
+// the write position advancing in lockstep with it.
+static size_t get_distance(
+    const size_t dict_size,
+    const size_t initial_dict_pos,
+    const size_t output_pos,
+    const size_t match_pos)
 {
-    io::MsbBitStream bit_stream(input);
-    return lzss_decompress(bit_stream, output_size, settings);
+    const auto dict_pos = (initial_dict_pos + output_pos) & (dict_size - 1);
+    const auto distance = (dict_pos - match_pos) & (dict_size - 1);
+    return distance ? distance : dict_size;
 }
 
-bstr algo::pack::lzss_decompress(
-    io::BaseBitStream &input_stream,
+// Copies a match of the given size, which must fit in the output. The
+// decompressors don't keep a separate dictionary: before the start of the
+// output, the bytes come from a virtual prefix of zeros that stands for
+// its initial contents.
+static u8 *copy_match(
+    const u8 *output_start, u8 *output_ptr, size_t distance, size_t size)
+{
+    const size_t output_pos = output_ptr - output_start;
+    if (distance > output_pos)
+    {
+        const auto zero_count = std::min(distance - output_pos, size);
+        std::memset(output_ptr, 0, zero_count);
+        output_ptr += zero_count;
+        size -= zero_count;
+        if (!size)
+            return output_ptr;
+    }
+    auto source_ptr = output_ptr - distance;
+    while (size--)
+        *output_ptr++ = *source_ptr++;
+    return output_ptr;
+}
+
+// Same as above, but needs copy_slack bytes of room after the match.
+static u8 *copy_match_fast(
+    const u8 *output_start, u8 *output_ptr, size_t distance, size_t size)
+{
+    if (distance > static_cast<size_t>(output_ptr - output_start))
+        return copy_match(output_start, output_ptr, distance, size);
+    const u8 *source_ptr = output_ptr - distance;
+    const auto match_end = output_ptr + size;
+    if (distance >= 16)
+    {
+        // each chunk is read before the bytes it overlaps get written
+        do
+        {
+            std::memcpy(output_ptr, source_ptr, 16);
+            output_ptr += 16;
+            source_ptr += 16;
+        }
+        while (output_ptr < match_end);
+    }
+    else if (distance >= 8)
+    {
+        do
+        {
+            std::memcpy(output_ptr, source_ptr, 8);
+            output_ptr += 8;
+            source_ptr += 8;
+        }
+        while (output_ptr < match_end);
+    }
+    else if (distance == 1)
+        std::memset(output_ptr, *source_ptr, size);
+    else
+    {
+        while (output_ptr < match_end)
+            *output_ptr++ = *source_ptr++;
+    }
+    return match_end;
+}
+
+// works both with the bit streams and with the bit readers, which avoid
+// virtual calls for the common case of decompressing a buffer
+template<typename T> static bstr lzss_decompress_impl(
+    T &input_stream,
     const size_t output_size,
-    const BitwiseLzssSettings &settings)
+    const algo::pack::BitwiseLzssSettings &settings)
 {
-    std::vector<u8> dict(1 << settings.position_bits, 0);
-    auto dict_ptr
-        = algo::make_cyclic_ptr(dict.data(), dict.size())
-        + settings.initial_dictionary_pos;
+    const size_t dict_size = 1 << settings.position_bits;
+    const auto max_match_size
+        = settings.min_match_size + (1 << settings.size_bits) - 1;
 
     bstr output(output_size);
-    auto output_ptr = algo::make_ptr(output);
-    while (output_ptr.left())
+    const auto output_start = output.get<u8>();
+    const auto output_end = output.end<u8>();
+    auto output_ptr = output_start;
+    while (output_ptr < output_end)
     {
+        const auto has_room = static_cast<size_t>(output_end - output_ptr)
+            >= max_match_size + copy_slack;
         if (input_stream.read(1))
         {
-            const auto b = input_stream.read(8);
-            *output_ptr++ = b;
-            *dict_ptr++ = b;
-        }
-        else
-        {
-            auto look_behind_pos = input_stream.read(settings.position_bits);
-            auto repetitions = input_stream.read(settings.size_bits)
-                + settings.min_match_size;
-            auto source_ptr
-                = algo::make_cyclic_ptr(dict.data(), dict.size())
-                + look_behind_pos;
-            while (repetitions-- && output_ptr.left())
-            {
-                const auto b = *source_ptr++;
-                *output_ptr++ = b;
-                *dict_ptr++ = b;
-            }
+            *output_ptr++ = input_stream.read(8);
+            continue;
         }
+        const auto match_pos = input_stream.read(settings.position_bits);
+        const auto match_size = input_stream.read(settings.size_bits)
+            + settings.min_match_size;
+        const auto distance = get_distance(
+            dict_size,
+            settings.initial_dictionary_pos,
+            output_ptr - output_start,
+            match_pos);
+        output_ptr = has_room
+            ? copy_match_fast(output_start, output_ptr, distance, match_size)
+            : copy_match(
+                output_start,
+                output_ptr,
+                distance,
+                std::min<size_t>(match_size, output_end - output_ptr));
     }
     return output;
 }
 
+bstr algo::pack::lzss_decompress(
+    const bstr &input,
+    const size_t output_size,
+    const BitwiseLzssSettings &settings)
+{
+    io::BitReader<io::BitOrder::Msb> bit_reader(
+        input.get<u8>(), input.size());
+    return lzss_decompress_impl(bit_reader, output_size, settings);
+}
+
+bstr algo::pack::lzss_decompress(
+    io::BaseBitStream &input_stream,
+    const size_t output_size,
+    const BitwiseLzssSettings &settings)
+{
+    return lzss_decompress_impl(input_stream, output_size, settings);
+}
+
 bstr algo::pack::lzss_decompress(
     const bstr &input,
     const size_t output_size,
     const BytewiseLzssSettings &settings)
 {
-    std::array<u8, 0x1000> dict = {0};
-    auto dict_ptr
-        = algo::make_cyclic_ptr(dict.data(), dict.size())
-        + settings.initial_dictionary_pos;
+    static const size_t dict_size = 0x1000;
+    static const size_t max_match_size = 0xF + 3;
 
     bstr output(output_size);
-    auto output_ptr = algo::make_ptr(output);
-    auto input_ptr = algo::make_ptr(input);
+    const auto output_start = output.get<u8>();
+    const auto output_end = output.end<u8>();
+    auto output_ptr = output_start;
+    auto input_ptr = input.get<u8>();
+    const auto input_end = input.end<u8>();
+
+    // while there is room for a whole group of 8 literals or matches,
+    // they can be decoded without checking the bounds
+    while (input_end - input_ptr >= 1 + 8 * 2
+        && static_cast<size_t>(output_end - output_ptr)
+            >= 8 * max_match_size + copy_slack)
+    {
+        const auto control = *input_ptr++;
+        for (const auto i : algo::range(8))
+        {
+            if (control & (1 << i))
+            {
+                *output_ptr++ = *input_ptr++;
+                continue;
+            }
+            const auto lo = *input_ptr++;
+            const auto hi = *input_ptr++;
+            const auto distance = get_distance(
+                dict_size,
+                settings.initial_dictionary_pos,
+                output_ptr - output_start,
+                lo | ((hi & 0xF0) << 4));
+            output_ptr = copy_match_fast(
+                output_start, output_ptr, distance, (hi & 0xF) + 3);
+        }
+    }
 
     u16 control = 0;
-    while (output_ptr.left())
+    while (output_ptr < output_end)
     {
         control >>= 1;
         if (!(control & 0x100))
         {
-            if (!input_ptr.left()) break;
+            if (input_ptr == input_end) break;
             control = *input_ptr++ | 0xFF00;
         }
         if (control & 1)
         {
-            if (!input_ptr.left()) break;
-            const auto b = *input_ptr++;
-            *output_ptr++ = b;
-            *dict_ptr++ = b;
+            if (input_ptr == input_end) break;
+            *output_ptr++ = *input_ptr++;
         }
         else
         {
-            if (input_ptr.left() < 2) break;
+            if (input_end - input_ptr < 2) break;
             const auto lo = *input_ptr++;
             const auto hi = *input_ptr++;
-            const auto look_behind_pos = lo | ((hi & 0xF0) << 4);
-            auto repetitions = (hi & 0xF) + 3;
-            auto source_ptr
-                = algo::make_cyclic_ptr(dict.data(), dict.size())
-                + look_behind_pos;
-            while (repetitions-- && output_ptr.left())
-            {
-                const auto b = *source_ptr++;
-                *output_ptr++ = b;
-                *dict_ptr++ = b;
-            }
+            const auto distance = get_distance(
+                dict_size,
+                settings.initial_dictionary_pos,
+                output_ptr - output_start,
+                lo | ((hi & 0xF0) << 4));
+            output_ptr = copy_match(
+                output_start,
+                output_ptr,
+                distance,
+                std::min<size_t>((hi & 0xF) + 3, output_end - output_ptr));
         }
     }
     return output;
 }
 
-LzssEncoderState::LzssEncoderState(
-    const size_t dict_size, const size_t max_match_size) :
-        dict_size(dict_size),
+static const size_t hash_bits = 15;
+static const u32 no_position = 0xFFFFFFFF;
+
+LzssMatchFinder::LzssMatchFinder(
+    const bstr &data,
+    const size_t window_size,
+    const size_t min_match_size,
+    const size_t max_match_size,
+    const size_t max_chain_length) :
+        data(data.get<u8>()),
+        data_size(data.size()),
+        window_size(window_size),
+        min_match_size(min_match_size),
         max_match_size(max_match_size),
-        empty(dict_size),
-        text_buf(dict_size + max_match_size),
-        dad(dict_size + 1)
+        max_chain_length(max_chain_length),
+        hash_size(std::max<size_t>(1, std::min<size_t>(3, min_match_size))),
+        head(1 << hash_bits, no_position),
+        prev(window_size, no_position)
 {
-    children[0].resize(dict_size + 1);
-    children[1].resize(dict_size + 1 + 256);
-    for (auto &c : children[0]) c = empty;
-    for (auto &c : children[1]) c = empty;
-    for (auto &c : dad) c = empty;
 }
 
-void LzssEncoderState::insert_node(int r)
+size_t LzssMatchFinder::hash(const size_t pos) const
 {
-    int cmp = 1;
-    int p = dict_size + 1 + text_buf[r];
-    children[0][r] = children[1][r] = empty;
-    match_size = 0;
-    while (true)
-    {
-        const auto lr = cmp >= 0;
-        if (children[lr][p] == empty)
-        {
-            children[lr][p] = r;
-            dad[r] = p;
-            return;
-        }
-        p = children[lr][p];
-        size_t i = 0;
-        while (++i < max_match_size)
-            if ((cmp = text_buf[r + i] - text_buf[p + i]) != 0)
-                break;
-        if (i > match_size)
-        {
-            match_position = p;
-            if ((match_size = i) >= max_match_size)
-                break;
-        }
-    }
-    dad[r] = dad[p];
-    children[0][r] = children[0][p];
-    children[1][r] = children[1][p];
-    dad[children[0][p]] = r;
-    dad[children[1][p]] = r;
-    children[children[1][dad[p]] == p][dad[p]] = r;
-    dad[p] = empty;
+    u32 value = 0;
+    for (const auto i : algo::range(hash_size))
+        value = (value << 8) | data[pos + i];
+    return (value * 2654435761u) >> (32 - hash_bits);
 }
 
-void LzssEncoderState::delete_node(int p)
+void LzssMatchFinder::insert(const size_t pos)
 {
-    if (dad[p] == empty)
+    if (pos + hash_size > data_size)
         return;
+    const auto key = hash(pos);
+    prev[pos & (window_size - 1)] = head[key];
+    head[key] = pos;
+}
 
-    int  q;
-    if (children[1][p] == empty)
-        q = children[0][p];
-    else if (children[0][p] == empty)
-        q = children[1][p];
-    else
+LzssMatch LzssMatchFinder::find(const size_t pos) const
+{
+    LzssMatch match = {0, 0};
+    const auto max_size = std::min(max_match_size, data_size - pos);
+    if (max_size < min_match_size || max_size < hash_size)
+        return match;
+
+    // only positions before this one were inserted, so the chain entries
+    // within the window weren't overwritten by the newer ones yet
+    auto candidate = head[hash(pos)];
+    auto chain_length = max_chain_length;
+    while (candidate != no_position && chain_length--)
     {
-        q = children[0][p];
-        if (children[1][q] != empty)
+        const auto distance = pos - candidate;
+        if (distance > window_size)
+            break;
+        // a candidate can only be better if it matches one byte further
+        if (data[candidate + match.size] == data[pos + match.size])
         {
-            do
-                q = children[1][q];
-            while (children[1][q] != empty);
-
-            children[1][dad[q]] = children[0][q];
-            dad[children[0][q]] = dad[q];
-            children[0][q] = children[0][p];
-            dad[children[0][p]] = q;
+            const auto source = data + candidate;
+            const auto target = data + pos;
+            size_t size = 0;
+            while (size < max_size && source[size] == target[size])
+                size++;
+            if (size > match.size)
+            {
+                match.size = size;
+                match.distance = distance;
+                if (size == max_size)
+                    break;
+            }
         }
-
-        children[1][q] = children[1][p];
-        dad[children[1][p]] = q;
+        candidate = prev[candidate & (window_size - 1)];
     }
-
-    dad[q] = dad[p];
-    children[children[1][dad[p]] == p][dad[p]] = q;
-    dad[p] = empty;
+    if (match.size < min_match_size)
+        match.size = 0;
+    return match;
 }
 
 template<typename ConcreteLzssWriter> static bstr base_lzss_compress(
-    io::BaseByteStream &input_stream,
-    const algo::pack::BitwiseLzssSettings &settings)
+    const bstr &input,
+    const algo::pack::BitwiseLzssSettings &settings,
+    const algo::pack::LzssEffort effort)
 {
-    const auto dict_size = 1 << settings.position_bits;
-    const auto max_match_size
+    const size_t dict_size = 1 << settings.position_bits;
+    const size_t max_match_size
         = settings.min_match_size + (1 << settings.size_bits) - 1;
-    ConcreteLzssWriter writer;
-    LzssEncoderState state(dict_size, max_match_size);
 
-    size_t s = 0;
-    size_t r = dict_size - max_match_size;
-    for (const auto i : algo::range(s, r))
-        state.text_buf[i] = 0;
+    size_t max_chain_length = dict_size;
+    bool lazy = true;
+    if (effort == algo::pack::LzssEffort::Fast)
+    {
+        max_chain_length = 4;
+        lazy = false;
+    }
+    else if (effort == algo::pack::LzssEffort::Normal)
+        max_chain_length = 32;
+
+    // the dictionary starts out zeroed, which the decompressors treat as
+    // zeros preceding the output; enough of them to fill a whole match are
+    // prepended so that matches can refer to them
+    const auto prefix_size = std::min(dict_size, max_match_size);
+    bstr data(prefix_size);
+    data += input;
+
+    LzssMatchFinder finder(
+        data,
+        dict_size,
+        settings.min_match_size,
+        max_match_size,
+        max_chain_length);
+    for (const auto pos : algo::range(prefix_size))
+        finder.insert(pos);
 
-    size_t len;
-    for (len = 0; len < max_match_size && input_stream.left(); len++)
-        state.text_buf[r + len] = input_stream.read<u8>();
+    ConcreteLzssWriter writer;
+    size_t pos = prefix_size;
+    auto match = finder.find(pos);
+    while (pos < data.size())
+    {
+        finder.insert(pos);
 
-    for (const auto i : algo::range(1, max_match_size + 1))
-        state.insert_node(r - i);
-    state.insert_node(r);
+        // if the next position starts a longer match, prefer it over the
+        // current one at the cost of a literal
+        if (lazy && match.size && match.size < max_match_size)
+        {
+            const auto next_match = finder.find(pos + 1);
+            if (next_match.size > match.size)
+            {
+                writer.write_literal(data[pos++]);
+                match = next_match;
+                continue;
+            }
+        }
 
-    while (len > 0)
-    {
-        auto match_size = state.match_size;
-        auto match_position = state.match_position;
-        if (match_size > len)
-            match_size = len;
-        if (match_size < settings.min_match_size)
+        if (!match.size)
         {
-            match_size = 1;
-            writer.write_literal(state.text_buf[r]);
+            writer.write_literal(data[pos++]);
         }
         else
         {
-            match_position -= dict_size - max_match_size;
-            match_position += settings.initial_dictionary_pos;
-            match_position %= dict_size;
+            const auto output_pos = pos - prefix_size;
+            const auto match_pos = (settings.initial_dictionary_pos
+                + output_pos + dict_size - match.distance) & (dict_size - 1);
             writer.write_repetition(
                 settings.position_bits,
-                match_position,
+                match_pos,
                 settings.size_bits,
-                match_size - settings.min_match_size);
-        }
-
-        auto last_match_size = match_size;
-        size_t i;
-        for (i = 0; i < last_match_size && input_stream.left(); i++)
-        {
-            const auto c = input_stream.read<u8>();
-            state.delete_node(s);
-            state.text_buf[s] = c;
-            if (s < max_match_size + 1)
-                state.text_buf[s + dict_size] = c;
-            s = (s + 1) % dict_size;
-            r = (r + 1) % dict_size;
-            state.insert_node(r);
-        }
-        while (i++ < last_match_size)
-        {
-            state.delete_node(s);
-            s = (s + 1) % dict_size;
-            r = (r + 1) % dict_size;
-            if (--len)
-                state.insert_node(r);
+                match.size - settings.min_match_size);
+            for (const auto i : algo::range(1, match.size))
+                finder.insert(pos + i);
+            pos += match.size;
         }
+        match = finder.find(pos);
     }
     return writer.retrieve();
 }
 
+static algo::pack::BitwiseLzssSettings get_bitwise_settings(
+    const algo::pack::BytewiseLzssSettings &settings)
+{
+    algo::pack::BitwiseLzssSettings bitwise_settings;
+    bitwise_settings.min_match_size = 3;
+    bitwise_settings.position_bits = 12;
+    bitwise_settings.size_bits = 4;
+    bitwise_settings.initial_dictionary_pos = settings.initial_dictionary_pos;
+    return bitwise_settings;
+}
+
 bstr algo::pack::lzss_compress(
-    const bstr &input, const algo::pack::BitwiseLzssSettings &settings)
+    const bstr &input,
+    const algo::pack::BitwiseLzssSettings &settings,
+    const LzssEffort effort)
 {
-    io::MemoryStream input_stream(input);
-    return lzss_compress(input_stream, settings);
+    return base_lzss_compress<BitwiseLzssWriter>(input, settings, effort);
 }
 
 bstr algo::pack::lzss_compress(
     io::BaseByteStream &input_stream,
-    const algo::pack::BitwiseLzssSettings &settings)
+    const algo::pack::BitwiseLzssSettings &settings,
+    const LzssEffort effort)
 {
-    return base_lzss_compress<BitwiseLzssWriter>(input_stream, settings);
+    return lzss_compress(input_stream.read_to_eof(), settings, effort);
 }
 
 bstr algo::pack::lzss_compress(
-    const bstr &input, const algo::pack::BytewiseLzssSettings &settings)
+    const bstr &input,
+    const algo::pack::BytewiseLzssSettings &settings,
+    const LzssEffort effort)
 {
-    io::MemoryStream input_stream(input);
-    return lzss_compress(input_stream, settings);
+    return base_lzss_compress<BytewiseLzssWriter>(
+        input, get_bitwise_settings(settings), effort);
 }
 
 bstr algo::pack::lzss_compress(
     io::BaseByteStream &input_stream,
-    const algo::pack::BytewiseLzssSettings &settings)
+    const algo::pack::BytewiseLzssSettings &settings,
+    const LzssEffort effort)
 {
-    BitwiseLzssSettings bitwise_settings;
-    bitwise_settings.min_match_size = 3;
-    bitwise_settings.position_bits = 12;
-    bitwise_settings.size_bits = 4;
-    bitwise_settings.initial_dictionary_pos = settings.initial_dictionary_pos;
-    return base_lzss_compress<BytewiseLzssWriter>(
-        input_stream, bitwise_settings);
+    return lzss_compress(input_stream.read_to_eof(), settings, effort);
 }
@@ -22,6 +22,16 @@ namespace pack {
         size_t initial_dictionary_pos;
     };
 
+    // Trades compression speed for ratio. Fast takes the first good enough
+    // match, the other levels search further back and defer a match when
+    // the next byte starts a longer one.
+    enum class LzssEffort : u8
+    {
+        Fast,
+        Normal,
+        Best,
+    };
+
     bstr lzss_decompress(
         const bstr &input,
         const size_t output_size,
@@ -38,19 +48,23 @@ namespace pack {
         const BytewiseLzssSettings &settings = BytewiseLzssSettings());
 
     bstr lzss_compress(
-        const bstr &input, const algo::pack::BitwiseLzssSettings &settings);
+        const bstr &input,
+        const BitwiseLzssSettings &settings,
+        const LzssEffort effort = LzssEffort::Normal);
 
     bstr lzss_compress(
         io::BaseByteStream &input_stream,
-        const BitwiseLzssSettings &settings);
+        const BitwiseLzssSettings &settings,
+        const LzssEffort effort = LzssEffort::Normal);
 
     bstr lzss_compress(
         const bstr &input,
-        const BytewiseLzssSettings &settings = BytewiseLzssSettings());
+        const BytewiseLzssSettings &settings = BytewiseLzssSettings(),
+        const LzssEffort effort = LzssEffort::Normal);
 
     bstr lzss_compress(
         io::BaseByteStream &input_stream,
-        const BytewiseLzssSettings &settings);
-
+        const BytewiseLzssSettings &settings,
+        const LzssEffort effort = LzssEffort::Normal);
 
 } } }
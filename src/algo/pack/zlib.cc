@@ -10,14 +10,9 @@ using namespace au;
 using namespace au::algo::pack;
 
 static const int buffer_size = 8192;
+static const size_t max_deflate_ratio = 1032;
 
-static bstr process_stream(
-    io::BaseByteStream &input_stream,
-    const ZlibKind kind,
-    const std::function<int(z_stream &s, const int window_bits)> &init_func,
-    const std::function<int(z_stream &s)> &process_func,
-    const std::function<int(z_stream &s)> &end_func,
-    const std::string &error_message)
+static int get_window_bits(const ZlibKind kind)
 {
     const int window_bits
         = kind == ZlibKind::RawDeflate ? -MAX_WBITS
@@ -26,6 +21,18 @@ static bstr process_stream(
         : 0;
     if (!window_bits)
         throw std::logic_error("Bad zlib kind");
+    return window_bits;
+}
+
+static bstr process_stream(
+    io::BaseByteStream &input_stream,
+    const ZlibKind kind,
+    const std::function<int(z_stream &s, const int window_bits)> &init_func,
+    const std::function<int(z_stream &s)> &process_func,
+    const std::function<int(z_stream &s)> &end_func,
+    const std::string &error_message)
+{
+    const auto window_bits = get_window_bits(kind);
 
     z_stream s;
     std::memset(&s, 0, sizeof(s));
@@ -103,6 +110,62 @@ bstr algo::pack::zlib_inflate(const bstr &input, const ZlibKind kind)
     return ::zlib_inflate(input_stream, kind);
 }
 
+static bstr inflate_with_size_hint(
+    const u8 *input,
+    const size_t input_size,
+    const size_t expected_output_size,
+    const ZlibKind kind)
+{
+    // deflate can't compress better than this, so bigger sizes can only
+    // come from corrupt headers and aren't worth allocating
+    if (expected_output_size <= input_size * max_deflate_ratio + buffer_size)
+    {
+        z_stream s;
+        std::memset(&s, 0, sizeof(s));
+        if (inflateInit2(&s, get_window_bits(kind)) != Z_OK)
+            throw std::logic_error("Failed to initialize zlib stream");
+
+        bstr output(expected_output_size);
+        s.next_in = const_cast<Bytef*>(input);
+        s.avail_in = input_size;
+        s.next_out = output.get<Bytef>();
+        s.avail_out = output.size();
+        const auto ret = inflate(&s, Z_FINISH);
+        const auto total_out = s.total_out;
+        inflateEnd(&s);
+
+        if (ret == Z_STREAM_END)
+        {
+            output.resize(total_out);
+            return output;
+        }
+    }
+
+    // either the hint was wrong or the data is corrupt - the regular path
+    // handles both, including reporting the error
+    io::MemoryStream input_stream(
+        reinterpret_cast<const char*>(input), input_size);
+    return ::zlib_inflate(input_stream, kind);
+}
+
+bstr algo::pack::zlib_inflate(
+    const bstr &input,
+    const size_t expected_output_size,
+    const ZlibKind kind)
+{
+    return inflate_with_size_hint(
+        input.get<u8>(), input.size(), expected_output_size, kind);
+}
+
+bstr algo::pack::zlib_inflate(
+    const bslice &input,
+    const size_t expected_output_size,
+    const ZlibKind kind)
+{
+    return inflate_with_size_hint(
+        input.get<u8>(), input.size(), expected_output_size, kind);
+}
+
 bstr algo::pack::zlib_deflate(
     const bstr &input,
     const ZlibKind kind,
@@ -133,3 +196,151 @@ bstr algo::pack::zlib_deflate(
         },
         "Failed to deflate stream");
 }
+
+struct ZlibInflateStream::Priv final
+{
+    Priv(
+        std::unique_ptr<io::BaseByteStream> input_stream,
+        const size_t output_size,
+        const ZlibKind kind);
+    ~Priv();
+
+    void reset();
+    void inflate_into(u8 *destination, const size_t size);
+
+    std::unique_ptr<io::BaseByteStream> input_stream;
+    const size_t input_offset;
+    const size_t output_size;
+    const ZlibKind kind;
+
+    z_stream s;
+    bool initialized;
+    bstr input_chunk;
+    size_t pos;
+};
+
+ZlibInflateStream::Priv::Priv(
+    std::unique_ptr<io::BaseByteStream> input_stream,
+    const size_t output_size,
+    const ZlibKind kind) :
+        input_stream(std::move(input_stream)),
+        input_offset(this->input_stream->tell()),
+        output_size(output_size),
+        kind(kind),
+        initialized(false)
+{
+    reset();
+}
+
+ZlibInflateStream::Priv::~Priv()
+{
+    if (initialized)
+        inflateEnd(&s);
+}
+
+void ZlibInflateStream::Priv::reset()
+{
+    if (initialized)
+        inflateEnd(&s);
+    initialized = false;
+    std::memset(&s, 0, sizeof(s));
+    if (inflateInit2(&s, get_window_bits(kind)) != Z_OK)
+        throw std::logic_error("Failed to initialize zlib stream");
+    initialized = true;
+    input_stream->seek(input_offset);
+    pos = 0;
+}
+
+void ZlibInflateStream::Priv::inflate_into(u8 *destination, const size_t size)
+{
+    s.next_out = reinterpret_cast<Bytef*>(destination);
+    s.avail_out = size;
+    while (s.avail_out)
+    {
+        if (!s.avail_in)
+        {
+            if (input_stream->eof())
+                throw err::BadDataSizeError();
+            input_chunk = input_stream->read(
+                std::min<size_t>(input_stream->left(), buffer_size));
+            s.next_in = input_chunk.get<Bytef>();
+            s.avail_in = input_chunk.size();
+        }
+
+        const auto ret = inflate(&s, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END && s.avail_out)
+            throw err::BadDataSizeError();
+        if (ret != Z_OK && ret != Z_STREAM_END)
+        {
+            throw err::CorruptDataError(algo::format(
+                "Failed to inflate zlib stream (%s)",
+                s.msg ? s.msg : "unknown error"));
+        }
+    }
+    pos += size;
+}
+
+ZlibInflateStream::ZlibInflateStream(
+    std::unique_ptr<io::BaseByteStream> input_stream,
+    const size_t output_size,
+    const ZlibKind kind)
+    : p(new Priv(std::move(input_stream), output_size, kind))
+{
+}
+
+ZlibInflateStream::~ZlibInflateStream()
+{
+}
+
+void ZlibInflateStream::read_impl(void *destination, const size_t size)
+{
+    if (p->pos + size > p->output_size)
+        throw err::EofError();
+    p->inflate_into(reinterpret_cast<u8*>(destination), size);
+}
+
+void ZlibInflateStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Writing to inflate streams is not supported");
+}
+
+void ZlibInflateStream::seek_impl(const size_t offset)
+{
+    if (offset > p->output_size)
+        throw err::EofError();
+    if (offset < p->pos)
+        p->reset();
+    bstr discarded(std::min<size_t>(offset - p->pos, buffer_size));
+    while (p->pos < offset)
+    {
+        p->inflate_into(
+            discarded.get<u8>(),
+            std::min<size_t>(offset - p->pos, discarded.size()));
+    }
+}
+
+void ZlibInflateStream::truncate_impl(const size_t new_size)
+{
+    throw err::NotSupportedError(
+        "Truncating inflate streams is not supported");
+}
+
+size_t ZlibInflateStream::tell() const
+{
+    return p->pos;
+}
+
+size_t ZlibInflateStream::size() const
+{
+    return p->output_size;
+}
+
+std::unique_ptr<io::BaseByteStream> ZlibInflateStream::clone() const
+{
+    auto input_stream = p->input_stream->clone();
+    input_stream->seek(p->input_offset);
+    auto ret = std::make_unique<ZlibInflateStream>(
+        std::move(input_stream), p->output_size, p->kind);
+    ret->seek(tell());
+    return std::move(ret);
+}
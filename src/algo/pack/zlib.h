@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include "algo/pack/compression_level.h"
 #include "io/base_byte_stream.h"
 #include "types.h"
@@ -22,10 +23,49 @@ namespace pack {
     bstr zlib_inflate(
         const bstr &input, const ZlibKind kind = ZlibKind::PlainZlib);
 
+    // Inflates the input with a single call straight into a buffer of the
+    // expected size. If the expected size turns out to be too small, falls
+    // back to the regular, growing path.
+    bstr zlib_inflate(
+        const bstr &input,
+        const size_t expected_output_size,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
+    bstr zlib_inflate(
+        const bslice &input,
+        const size_t expected_output_size,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
     bstr zlib_deflate(
         const bstr &input,
         const ZlibKind kind = ZlibKind::PlainZlib,
         const CompressionLevel = CompressionLevel::Best);
 
+    // Read-only stream that inflates its input incrementally, as it's being
+    // read. Seeking backwards restarts the inflation from the beginning.
+    class ZlibInflateStream final : public io::BaseByteStream
+    {
+    public:
+        ZlibInflateStream(
+            std::unique_ptr<io::BaseByteStream> input_stream,
+            const size_t output_size,
+            const ZlibKind kind = ZlibKind::PlainZlib);
+        ~ZlibInflateStream();
+
+        size_t size() const override;
+        size_t tell() const override;
+
+        std::unique_ptr<io::BaseByteStream> clone() const override;
+
+    protected:
+        void read_impl(void *destination, const size_t size) override;
+        void write_impl(const void *source, const size_t size) override;
+        void seek_impl(const size_t offset) override;
+        void truncate_impl(const size_t new_size) override;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
 
 } } }
@@ -0,0 +1,135 @@
+#include "algo/parallel.h"
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "algo/range.h"
+
+using namespace au;
+
+static thread_local bool is_busy = false;
+
+static size_t get_core_count()
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+static std::atomic<size_t> &get_thread_budget()
+{
+    static std::atomic<size_t> thread_budget(get_core_count());
+    return thread_budget;
+}
+
+static std::atomic<size_t> &get_busy_count()
+{
+    static std::atomic<size_t> busy_count(0);
+    return busy_count;
+}
+
+// takes as many of the wanted threads as the budget allows
+static size_t reserve_threads(const size_t wanted_count)
+{
+    const size_t thread_budget = get_thread_budget();
+    auto &busy_count = get_busy_count();
+    auto current_busy_count = busy_count.load();
+    while (current_busy_count < thread_budget)
+    {
+        const auto count = std::min(
+            wanted_count, thread_budget - current_busy_count);
+        if (busy_count.compare_exchange_weak(
+                current_busy_count, current_busy_count + count))
+        {
+            return count;
+        }
+    }
+    return 0;
+}
+
+void algo::set_thread_budget(const size_t thread_count)
+{
+    get_thread_budget() = thread_count ? thread_count : get_core_count();
+}
+
+algo::BusyThreadScope::BusyThreadScope() : was_busy(is_busy)
+{
+    if (!was_busy)
+    {
+        ++get_busy_count();
+        is_busy = true;
+    }
+}
+
+algo::BusyThreadScope::~BusyThreadScope()
+{
+    if (!was_busy)
+    {
+        --get_busy_count();
+        is_busy = false;
+    }
+}
+
+void algo::parallel_for(
+    const size_t count,
+    const std::function<void(const size_t)> callback,
+    size_t thread_count)
+{
+    if (!thread_count)
+        thread_count = get_thread_budget();
+    thread_count = std::min(thread_count, count);
+
+    BusyThreadScope busy;
+    const auto extra_thread_count
+        = thread_count > 1 ? reserve_threads(thread_count - 1) : 0;
+    if (!extra_thread_count)
+    {
+        for (const auto i : algo::range(count))
+            callback(i);
+        return;
+    }
+
+    std::atomic<size_t> next_index(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    const auto work = [&]()
+    {
+        while (!failed)
+        {
+            const auto i = next_index++;
+            if (i >= count)
+                break;
+            try
+            {
+                callback(i);
+            }
+            catch (...)
+            {
+                std::unique_lock<std::mutex> lock(exception_mutex);
+                if (!exception)
+                    exception = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    // the calling thread works as well; the started threads occupy the
+    // budget reserved above
+    std::vector<std::thread> threads;
+    for (const auto i : algo::range(extra_thread_count))
+    {
+        threads.emplace_back([&]()
+        {
+            is_busy = true;
+            work();
+        });
+    }
+    work();
+    for (auto &thread : threads)
+        thread.join();
+    get_busy_count() -= extra_thread_count;
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace au {
+namespace algo {
+
+    // Calls the callback for every index in [0, count) using a short-lived
+    // pool of threads. Indices are handed out one by one, so the callback
+    // should do a reasonable amount of work per call. The first exception
+    // thrown by any of the calls is rethrown after all threads finish.
+    //
+    // The thread count, which includes the calling thread, defaults to the
+    // thread budget. Only the part of the budget that no busy thread
+    // occupies gets started, so calls made while the rest of the process
+    // is busy run inline.
+    void parallel_for(
+        const size_t count,
+        const std::function<void(const size_t)> callback,
+        size_t thread_count = 0);
+
+    // Sets how many threads may be busy across the whole process before
+    // parallel_for stops starting new ones; 0 means the number of cores.
+    void set_thread_budget(const size_t thread_count);
+
+    // Counts the current thread as busy for as long as the object lives.
+    // Workers of a thread pool hold it while running a task, so that the
+    // budget left for parallel_for is what the idle workers don't use.
+    // Since it never waits, workers that start while the idle part is lent
+    // out can briefly push the process up to twice the budget.
+    // The threads of parallel_for, including the calling one, are busy
+    // while it runs.
+    class BusyThreadScope final
+    {
+    public:
+        BusyThreadScope();
+        ~BusyThreadScope();
+
+    private:
+        const bool was_busy;
+    };
+
+} }
@@ -117,6 +117,21 @@ std::string algo::replace_all(
     return output;
 }
 
+std::string algo::escape_json(const std::string &input)
+{
+    std::string output;
+    for (const auto c : input)
+    {
+        if (c == '"' || c == '\\')
+            output += std::string("\\") + c;
+        else if (static_cast<u8>(c) < 0x20)
+            output += algo::format("\\u%04x", c);
+        else
+            output += c;
+    }
+    return output;
+}
+
 
 namespace au {
 namespace algo {
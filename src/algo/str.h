@@ -31,6 +31,9 @@ namespace algo {
         const std::string &from,
         const std::string &to);
 
+    // for use inside double quoted JSON strings
+    std::string escape_json(const std::string &input);
+
     template<typename T> T from_string(const std::string &input);
 
 } }
@@ -61,4 +61,5 @@ std::vector<std::string> AdpackArchiveDecoder::get_linked_formats() const
 }
 
 static auto _
-    = dec::register_decoder<AdpackArchiveDecoder>("active-soft/adpack");
+    = dec::register_decoder<AdpackArchiveDecoder>("active-soft/adpack")
+    .add_magic(magic);
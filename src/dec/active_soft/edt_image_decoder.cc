@@ -35,7 +35,7 @@ res::Image EdtImageDecoder::decode_impl(
     std::string base_file_name;
     if (meta_size)
     {
-        io::MemoryStream meta_stream(input_file.stream.read(meta_size));
+        io::MemoryStream meta_stream(input_file.stream.read_slice(meta_size));
         if (meta_stream.read(diff_magic.size()) == diff_magic)
         {
             transparent_color
@@ -65,7 +65,7 @@ res::Image EdtImageDecoder::decode_impl(
     output.reserve(target_size);
 
     CustomBitStream bit_stream(input_file.stream.read(data_size));
-    io::MemoryStream raw_stream(input_file.stream.read(raw_size));
+    io::MemoryStream raw_stream(input_file.stream.read_slice(raw_size));
     output += raw_stream.read(channels);
     while (output.size() < target_size)
     {
@@ -115,4 +115,5 @@ res::Image EdtImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<EdtImageDecoder>("active-soft/edt");
+static auto _ = dec::register_decoder<EdtImageDecoder>("active-soft/edt")
+    .add_magic(magic);
@@ -43,7 +43,8 @@ std::unique_ptr<dec::ArchiveMeta> AfaArchiveDecoder::read_meta_impl(
 
     io::MemoryStream table_stream(
         algo::pack::zlib_inflate(
-            input_file.stream.read(table_size_compressed)));
+            input_file.stream.read_slice(table_size_compressed),
+            table_size_original));
 
     auto meta = std::make_unique<ArchiveMeta>();
     for (auto i : algo::range(file_count))
@@ -82,4 +83,5 @@ std::vector<std::string> AfaArchiveDecoder::get_linked_formats() const
     return {"alice-soft/aff", "alice-soft/ajp", "alice-soft/qnt"};
 }
 
-static auto _ = dec::register_decoder<AfaArchiveDecoder>("alice-soft/afa");
+static auto _ = dec::register_decoder<AfaArchiveDecoder>("alice-soft/afa")
+    .add_magic(magic1);
@@ -30,4 +30,5 @@ std::unique_ptr<io::File> AffFileDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<AffFileDecoder>("alice-soft/aff");
+static auto _ = dec::register_decoder<AffFileDecoder>("alice-soft/aff")
+    .add_magic(magic);
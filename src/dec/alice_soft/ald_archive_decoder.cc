@@ -74,4 +74,5 @@ std::vector<std::string> AldArchiveDecoder::get_linked_formats() const
     return {"alice-soft/pms", "alice-soft/vsp", "alice-soft/qnt"};
 }
 
-static auto _ = dec::register_decoder<AldArchiveDecoder>("alice-soft/ald");
+static auto _ = dec::register_decoder<AldArchiveDecoder>("alice-soft/ald")
+    .add_extension("ald");
@@ -187,4 +187,5 @@ res::Image VspImageDecoder::decode_impl(
     return *image;
 }
 
-static auto _ = dec::register_decoder<VspImageDecoder>("alice-soft/vsp");
+static auto _ = dec::register_decoder<VspImageDecoder>("alice-soft/vsp")
+    .add_extension("vsp");
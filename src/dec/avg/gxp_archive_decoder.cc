@@ -43,7 +43,7 @@ std::unique_ptr<dec::ArchiveMeta> GxpArchiveDecoder::read_meta_impl(
     const auto table_size = input_file.stream.read_le<u32>();
     input_file.stream.skip(8);
     const auto data_offset = input_file.stream.read_le<u64>();
-    io::MemoryStream table_stream(input_file.stream.read(table_size));
+    io::MemoryStream table_stream(input_file.stream.read_slice(table_size));
 
     auto meta = std::make_unique<dec::ArchiveMeta>();
     for (const auto i : algo::range(file_count))
@@ -79,4 +79,5 @@ std::unique_ptr<io::File> GxpArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, decrypt(data));
 }
 
-static auto _ = dec::register_decoder<GxpArchiveDecoder>("avg/gxp");
+static auto _ = dec::register_decoder<GxpArchiveDecoder>("avg/gxp")
+    .add_magic(magic);
@@ -92,3 +92,24 @@ std::unique_ptr<io::File> BaseArchiveDecoder::read_file(
     // wrapper reserved for future usage
     return read_file_impl(logger, input_file, e, m);
 }
+
+std::unique_ptr<io::File> BaseArchiveDecoder::stream_file(
+    const Logger &logger,
+    io::File &input_file,
+    const ArchiveMeta &m,
+    const ArchiveEntry &e) const
+{
+    auto output_file = stream_file_impl(logger, input_file, m, e);
+    if (output_file)
+        return output_file;
+    return read_file(logger, input_file, m, e);
+}
+
+std::unique_ptr<io::File> BaseArchiveDecoder::stream_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const ArchiveMeta &m,
+    const ArchiveEntry &e) const
+{
+    return nullptr;
+}
@@ -37,6 +37,16 @@ namespace dec {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const;
 
+        // Like read_file, but the returned file's stream reads the entry
+        // incrementally from the input file, so large entries never need to
+        // sit in memory as a whole. Falls back to read_file for decoders that
+        // don't support it.
+        std::unique_ptr<io::File> stream_file(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const;
+
     protected:
         virtual std::unique_ptr<ArchiveMeta> read_meta_impl(
             const Logger &logger,
@@ -48,6 +58,13 @@ namespace dec {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const = 0;
 
+        // returns nullptr if given entry can't be streamed
+        virtual std::unique_ptr<io::File> stream_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const;
+
     private:
         bool numeric_file_names;
     };
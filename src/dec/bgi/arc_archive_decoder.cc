@@ -58,4 +58,5 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
     return {"bgi/cbg", "bgi/dsc", "bgi/audio"};
 }
 
-static auto _ = dec::register_decoder<ArcArchiveDecoder>("bgi/arc");
+static auto _ = dec::register_decoder<ArcArchiveDecoder>("bgi/arc")
+    .add_magic(magic);
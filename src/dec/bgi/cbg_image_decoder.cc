@@ -47,4 +47,5 @@ res::Image CbgImageDecoder::decode_impl(
     throw err::UnsupportedVersionError(static_cast<int>(version));
 }
 
-static auto _ = dec::register_decoder<CbgImageDecoder>("bgi/cbg");
+static auto _ = dec::register_decoder<CbgImageDecoder>("bgi/cbg")
+    .add_magic(magic);
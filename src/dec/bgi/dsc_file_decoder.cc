@@ -192,4 +192,5 @@ std::unique_ptr<io::File> DscFileDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<DscFileDecoder>("bgi/dsc");
+static auto _ = dec::register_decoder<DscFileDecoder>("bgi/dsc")
+    .add_magic(magic);
@@ -6,6 +6,7 @@
 #include "err.h"
 #include "io/memory_stream.h"
 #include "io/msb_bit_stream.h"
+#include "io/sub_stream.h"
 
 using namespace au;
 using namespace au::dec::cri;
@@ -407,9 +408,31 @@ std::unique_ptr<io::File> CpkArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
+std::unique_ptr<io::File> CpkArchiveDecoder::stream_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const dec::ArchiveMeta &m,
+    const dec::ArchiveEntry &e) const
+{
+    const auto entry = static_cast<const ArchiveEntryImpl*>(&e);
+    if (entry->size >= layla_magic.size())
+    {
+        const auto magic = input_file.stream
+            .seek(entry->offset)
+            .read(layla_magic.size());
+        if (magic == layla_magic)
+            return nullptr;
+    }
+    return std::make_unique<io::File>(
+        entry->path,
+        std::make_unique<io::SubStream>(
+            input_file.stream, entry->offset, entry->size));
+}
+
 std::vector<std::string> CpkArchiveDecoder::get_linked_formats() const
 {
     return {"cri/hca", "playstation/gxt"};
 }
 
-static auto _ = dec::register_decoder<CpkArchiveDecoder>("cri/cpk");
+static auto _ = dec::register_decoder<CpkArchiveDecoder>("cri/cpk")
+    .add_magic(magic);
@@ -270,4 +270,5 @@ res::Audio HcaAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<HcaAudioDecoder>("cri/hca");
+static auto _ = dec::register_decoder<HcaAudioDecoder>("cri/hca")
+    .add_magic(magic);
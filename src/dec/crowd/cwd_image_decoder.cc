@@ -21,4 +21,5 @@ res::Image CwdImageDecoder::decode_impl(
     return res::Image(width, height, data, res::PixelFormat::BGR555X);
 }
 
-static auto _ = dec::register_decoder<CwdImageDecoder>("crowd/cwd");
+static auto _ = dec::register_decoder<CwdImageDecoder>("crowd/cwd")
+    .add_magic(magic);
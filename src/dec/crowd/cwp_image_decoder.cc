@@ -48,4 +48,5 @@ res::Image CwpImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<CwpImageDecoder>("crowd/cwp");
+static auto _ = dec::register_decoder<CwpImageDecoder>("crowd/cwp")
+    .add_magic(magic);
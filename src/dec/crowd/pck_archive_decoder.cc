@@ -63,4 +63,5 @@ std::vector<std::string> PckArchiveDecoder::get_linked_formats() const
     return {"crowd/eog"};
 }
 
-static auto _ = dec::register_decoder<PckArchiveDecoder>("crowd/pck");
+static auto _ = dec::register_decoder<PckArchiveDecoder>("crowd/pck")
+    .add_extension("pck");
@@ -86,4 +86,5 @@ std::unique_ptr<io::File> PkwvAudioArchiveDecoder::read_file_impl(
     return encoder.encode(logger, audio, entry->path);
 }
 
-static auto _ = dec::register_decoder<PkwvAudioArchiveDecoder>("crowd/pkwv");
+static auto _ = dec::register_decoder<PkwvAudioArchiveDecoder>("crowd/pkwv")
+    .add_magic(magic);
@@ -0,0 +1,62 @@
+#include "dec/decoder_pool.h"
+#include <map>
+#include <mutex>
+
+using namespace au;
+using namespace au::dec;
+
+struct DecoderPool::Priv final
+{
+    Priv(const Registry &registry, const std::vector<std::string> &arguments);
+
+    std::shared_ptr<IDecoder> create_decoder(const std::string &name) const;
+
+    const Registry &registry;
+    const std::vector<std::string> arguments;
+
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<IDecoder>> decoders;
+};
+
+DecoderPool::Priv::Priv(
+    const Registry &registry, const std::vector<std::string> &arguments)
+    : registry(registry), arguments(arguments)
+{
+}
+
+std::shared_ptr<IDecoder> DecoderPool::Priv::create_decoder(
+    const std::string &name) const
+{
+    const auto decoder = registry.create_decoder(name);
+    ArgParser decoder_arg_parser;
+    const auto decorators = decoder->get_arg_parser_decorators();
+    for (const auto &decorator : decorators)
+        decorator.register_cli_options(decoder_arg_parser);
+    decoder_arg_parser.parse(arguments);
+    for (const auto &decorator : decorators)
+        decorator.parse_cli_options(decoder_arg_parser);
+    return decoder;
+}
+
+DecoderPool::DecoderPool(
+    const Registry &registry, const std::vector<std::string> &arguments)
+    : p(new Priv(registry, arguments))
+{
+}
+
+DecoderPool::~DecoderPool()
+{
+}
+
+std::shared_ptr<IDecoder> DecoderPool::get_decoder(const std::string &name)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto it = p->decoders.find(name);
+    if (it != p->decoders.end())
+        return it->second;
+    // decoders that fail to configure aren't cached so that every task
+    // reports the error on its own
+    const auto decoder = p->create_decoder(name);
+    p->decoders[name] = decoder;
+    return decoder;
+}
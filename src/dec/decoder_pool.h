@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "dec/idecoder.h"
+#include "dec/registry.h"
+
+namespace au {
+namespace dec {
+
+    // Decoders configured with command line options of a single run. Each
+    // decoder is constructed and configured once and then shared by all the
+    // tasks, since decoding itself doesn't mutate decoder state.
+    class DecoderPool final
+    {
+    public:
+        DecoderPool(
+            const Registry &registry,
+            const std::vector<std::string> &arguments);
+        ~DecoderPool();
+
+        std::shared_ptr<IDecoder> get_decoder(const std::string &name);
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
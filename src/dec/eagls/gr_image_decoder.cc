@@ -50,4 +50,5 @@ res::Image GrImageDecoder::decode_impl(
     return bmp_file_decoder.decode(logger, bmp_file);
 }
 
-static auto _ = dec::register_decoder<GrImageDecoder>("eagls/gr");
+static auto _ = dec::register_decoder<GrImageDecoder>("eagls/gr")
+    .add_extension("gr");
@@ -116,4 +116,5 @@ std::vector<std::string> MrgArchiveDecoder::get_linked_formats() const
     return {"fc01/acd", "fc01/mca", "fc01/mcg"};
 }
 
-static auto _ = dec::register_decoder<MrgArchiveDecoder>("fc01/mrg");
+static auto _ = dec::register_decoder<MrgArchiveDecoder>("fc01/mrg")
+    .add_magic(magic);
@@ -62,4 +62,5 @@ std::vector<std::string> BinArchiveDecoder::get_linked_formats() const
     return {"fvp/nvsg"};
 }
 
-static auto _ = dec::register_decoder<BinArchiveDecoder>("fvp/bin");
+static auto _ = dec::register_decoder<BinArchiveDecoder>("fvp/bin")
+    .add_extension("bin");
@@ -84,4 +84,5 @@ std::vector<std::string> GmlArchiveDecoder::get_linked_formats() const
     return {"glib/pgx", "vorbis/wav"};
 }
 
-static auto _ = dec::register_decoder<GmlArchiveDecoder>("glib/gml");
+static auto _ = dec::register_decoder<GmlArchiveDecoder>("glib/gml")
+    .add_magic(magic);
@@ -33,4 +33,5 @@ res::Image PgxImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<PgxImageDecoder>("glib/pgx");
+static auto _ = dec::register_decoder<PgxImageDecoder>("glib/pgx")
+    .add_magic(magic);
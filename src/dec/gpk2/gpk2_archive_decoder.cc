@@ -57,4 +57,5 @@ std::vector<std::string> Gpk2ArchiveDecoder::get_linked_formats() const
     return {"gpk2/gfb"};
 }
 
-static auto _ = dec::register_decoder<Gpk2ArchiveDecoder>("gpk2/gpk2");
+static auto _ = dec::register_decoder<Gpk2ArchiveDecoder>("gpk2/gpk2")
+    .add_magic(magic);
@@ -72,4 +72,5 @@ std::unique_ptr<io::File> DatArchiveDecoder::read_file_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<DatArchiveDecoder>("gs/dat");
+static auto _ = dec::register_decoder<DatArchiveDecoder>("gs/dat")
+    .add_magic(magic);
@@ -49,4 +49,5 @@ res::Image GsImageDecoder::decode_impl(
     throw err::UnsupportedBitDepthError(depth);
 }
 
-static auto _ = dec::register_decoder<GsImageDecoder>("gs/gfx");
+static auto _ = dec::register_decoder<GsImageDecoder>("gs/gfx")
+    .add_magic(magic);
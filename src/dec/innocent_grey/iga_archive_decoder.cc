@@ -106,4 +106,5 @@ std::unique_ptr<io::File> IgaArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<IgaArchiveDecoder>("innocent-grey/iga");
+static auto _ = dec::register_decoder<IgaArchiveDecoder>("innocent-grey/iga")
+    .add_magic(magic);
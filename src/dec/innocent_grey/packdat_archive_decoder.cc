@@ -72,4 +72,5 @@ std::unique_ptr<io::File> PackdatArchiveDecoder::read_file_impl(
 }
 
 static auto _ = dec::register_decoder<PackdatArchiveDecoder>(
-    "innocent-grey/packdat");
+    "innocent-grey/packdat")
+    .add_magic(magic);
@@ -57,4 +57,5 @@ std::vector<std::string> IsaArchiveDecoder::get_linked_formats() const
     return {"ism/isg"};
 }
 
-static auto _ = dec::register_decoder<IsaArchiveDecoder>("ism/isa");
+static auto _ = dec::register_decoder<IsaArchiveDecoder>("ism/isa")
+    .add_magic(magic);
@@ -231,4 +231,5 @@ res::Audio WadyAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<WadyAudioDecoder>("ivory/wady");
+static auto _ = dec::register_decoder<WadyAudioDecoder>("ivory/wady")
+    .add_magic(magic);
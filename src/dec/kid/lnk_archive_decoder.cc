@@ -94,4 +94,5 @@ std::vector<std::string> LnkArchiveDecoder::get_linked_formats() const
     return {"kid/cps", "kid/prt", "kid/waf"};
 }
 
-static auto _ = dec::register_decoder<LnkArchiveDecoder>("kid/lnk");
+static auto _ = dec::register_decoder<LnkArchiveDecoder>("kid/lnk")
+    .add_magic(magic);
@@ -30,4 +30,5 @@ res::Audio WafAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<WafAudioDecoder>("kid/waf");
+static auto _ = dec::register_decoder<WafAudioDecoder>("kid/waf")
+    .add_magic(magic);
@@ -4,6 +4,7 @@
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_stream.h"
+#include "io/sub_stream.h"
 
 using namespace au;
 using namespace au::dec::kirikiri;
@@ -134,14 +135,14 @@ static std::unique_ptr<ArchiveEntryImpl> read_entry(
         throw err::CorruptDataError("Expected FILE entry");
 
     const auto entry_size = input_stream.read_le<u64>();
-    io::MemoryStream entry_stream(input_stream.read(entry_size));
+    io::MemoryStream entry_stream(input_stream.read_slice(entry_size));
 
     auto entry = std::make_unique<ArchiveEntryImpl>();
     while (!entry_stream.eof())
     {
         const auto chunk_magic = entry_stream.read(4);
         const auto chunk_size = entry_stream.read_le<u64>();
-        io::MemoryStream chunk_stream(entry_stream.read(chunk_size));
+        io::MemoryStream chunk_stream(entry_stream.read_slice(chunk_size));
 
         if (chunk_magic == info_chunk_magic)
             entry->info_chunk = read_info_chunk(chunk_stream);
@@ -197,8 +198,8 @@ std::unique_ptr<dec::ArchiveMeta> Xp3ArchiveDecoder::read_meta_impl(
 
     auto table_data = input_file.stream.read(table_size_comp);
     if (table_is_compressed)
-        table_data = algo::pack::zlib_inflate(table_data);
-    io::MemoryStream table_stream(table_data);
+        table_data = algo::pack::zlib_inflate(table_data, table_size_orig);
+    io::MemoryStream table_stream(bslice(std::move(table_data)));
 
     auto meta = std::make_unique<ArchiveMetaImpl>();
     meta->decrypt_func = plugin_manager.get()
@@ -225,7 +226,8 @@ std::unique_ptr<io::File> Xp3ArchiveDecoder::read_file_impl(
         input_file.stream.seek(segm_chunk->offset);
         data += data_is_compressed
             ? algo::pack::zlib_inflate(
-                input_file.stream.read(segm_chunk->size_comp))
+                input_file.stream.read_slice(segm_chunk->size_comp),
+                segm_chunk->size_orig)
             : input_file.stream.read(segm_chunk->size_orig);
     }
 
@@ -235,9 +237,38 @@ std::unique_ptr<io::File> Xp3ArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
+std::unique_ptr<io::File> Xp3ArchiveDecoder::stream_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const dec::ArchiveMeta &m,
+    const dec::ArchiveEntry &e) const
+{
+    const auto meta = static_cast<const ArchiveMetaImpl*>(&m);
+    const auto entry = static_cast<const ArchiveEntryImpl*>(&e);
+    if (meta->decrypt_func || entry->segm_chunks.size() != 1)
+        return nullptr;
+
+    const auto &segm_chunk = entry->segm_chunks[0];
+    const auto data_is_compressed = segm_chunk->flags & 7;
+    if (!data_is_compressed)
+    {
+        return std::make_unique<io::File>(
+            entry->path,
+            std::make_unique<io::SubStream>(
+                input_file.stream, segm_chunk->offset, segm_chunk->size_orig));
+    }
+    return std::make_unique<io::File>(
+        entry->path,
+        std::make_unique<algo::pack::ZlibInflateStream>(
+            std::make_unique<io::SubStream>(
+                input_file.stream, segm_chunk->offset, segm_chunk->size_comp),
+            segm_chunk->size_orig));
+}
+
 std::vector<std::string> Xp3ArchiveDecoder::get_linked_formats() const
 {
     return {"kirikiri/tlg"};
 }
 
-static auto _ = dec::register_decoder<Xp3ArchiveDecoder>("kirikiri/xp3");
+static auto _ = dec::register_decoder<Xp3ArchiveDecoder>("kirikiri/xp3")
+    .add_magic(xp3_magic);
@@ -27,6 +27,12 @@ namespace kirikiri {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const override;
 
+        std::unique_ptr<io::File> stream_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const override;
+
     public:
         PluginManager<Xp3Plugin> plugin_manager;
     };
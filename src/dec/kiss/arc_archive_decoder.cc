@@ -70,4 +70,5 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
     return {"kiss/plg"};
 }
 
-static auto _ = dec::register_decoder<ArcArchiveDecoder>("kiss/arc");
+static auto _ = dec::register_decoder<ArcArchiveDecoder>("kiss/arc")
+    .add_extension("arc");
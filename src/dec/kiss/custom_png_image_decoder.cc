@@ -40,4 +40,5 @@ res::Image CustomPngImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<CustomPngImageDecoder>("kiss/custom-png");
+static auto _ = dec::register_decoder<CustomPngImageDecoder>("kiss/custom-png")
+    .add_magic(magic);
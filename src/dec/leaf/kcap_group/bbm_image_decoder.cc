@@ -27,7 +27,7 @@ res::Image BbmImageDecoder::decode_impl(
     for (auto chunk_y : algo::range(chunk_count_y))
     for (auto chunk_x : algo::range(chunk_count_x))
     {
-        io::MemoryStream chunk_stream(input_file.stream.read(chunk_size));
+        io::MemoryStream chunk_stream(input_file.stream.read_slice(chunk_size));
         chunk_stream.skip(5);
         auto color_num = chunk_stream.read_le<u16>();
         chunk_stream.skip(11);
@@ -46,4 +46,5 @@ res::Image BbmImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<BbmImageDecoder>("leaf/bbm");
+static auto _ = dec::register_decoder<BbmImageDecoder>("leaf/bbm")
+    .add_extension("bbm");
@@ -57,4 +57,5 @@ res::Image BjrImageDecoder::decode_impl(
     return output;
 }
 
-static auto _ = dec::register_decoder<BjrImageDecoder>("leaf/bjr");
+static auto _ = dec::register_decoder<BjrImageDecoder>("leaf/bjr")
+    .add_extension("bjr");
@@ -39,4 +39,5 @@ res::Image Lc3ImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<Lc3ImageDecoder>("leaf/lc3");
+static auto _ = dec::register_decoder<Lc3ImageDecoder>("leaf/lc3")
+    .add_magic(magic);
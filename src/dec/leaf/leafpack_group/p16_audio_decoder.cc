@@ -18,4 +18,5 @@ res::Audio P16AudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<P16AudioDecoder>("leaf/p16");
+static auto _ = dec::register_decoder<P16AudioDecoder>("leaf/p16")
+    .add_extension("P16");
@@ -81,4 +81,5 @@ std::vector<std::string> Pak2ArchiveDecoder::get_linked_formats() const
     };
 }
 
-static auto _ = dec::register_decoder<Pak2ArchiveDecoder>("leaf/pak2");
+static auto _ = dec::register_decoder<Pak2ArchiveDecoder>("leaf/pak2")
+    .add_extension("pak");
@@ -113,4 +113,5 @@ algo::NamingStrategy Pak2ImageArchiveDecoder::naming_strategy() const
 }
 
 static auto _ = dec::register_decoder<Pak2ImageArchiveDecoder>(
-    "leaf/pak2-image");
+    "leaf/pak2-image")
+    .add_magic(magic, 4);
@@ -128,4 +128,5 @@ algo::NamingStrategy Pak2TextureArchiveDecoder::naming_strategy() const
 }
 
 static auto _ = dec::register_decoder<Pak2TextureArchiveDecoder>(
-    "leaf/pak2-texture");
+    "leaf/pak2-texture")
+    .add_magic(magic, 4);
@@ -126,4 +126,5 @@ std::vector<std::string> AArchiveDecoder::get_linked_formats() const
     return {"leaf/w", "leaf/px"};
 }
 
-static auto _ = dec::register_decoder<AArchiveDecoder>("leaf/a");
+static auto _ = dec::register_decoder<AArchiveDecoder>("leaf/a")
+    .add_magic(magic);
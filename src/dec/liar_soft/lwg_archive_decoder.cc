@@ -66,4 +66,5 @@ std::vector<std::string> LwgArchiveDecoder::get_linked_formats() const
     return {"liar-soft/wcg", "liar-soft/lwg"};
 }
 
-static auto _ = dec::register_decoder<LwgArchiveDecoder>("liar-soft/lwg");
+static auto _ = dec::register_decoder<LwgArchiveDecoder>("liar-soft/lwg")
+    .add_magic(magic);
@@ -34,4 +34,5 @@ res::Image MncImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<MncImageDecoder>("libido/mnc");
+static auto _ = dec::register_decoder<MncImageDecoder>("libido/mnc")
+    .add_magic(magic);
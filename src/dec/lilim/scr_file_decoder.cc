@@ -1,38 +1,17 @@
 #include "dec/lilim/scr_file_decoder.h"
-#include "io/msb_bit_stream.h"
+#include "algo/pack/huffman.h"
 
 using namespace au;
 using namespace au::dec::lilim;
 
-static int init_huffman(
-    io::BaseBitStream &bit_stream, u16 nodes[2][512], int &size)
-{
-    if (!bit_stream.read(1))
-        return bit_stream.read(8);
-    const auto pos = size;
-    if (pos > 511)
-        return -1;
-    size++;
-    nodes[0][pos] = init_huffman(bit_stream, nodes, size);
-    nodes[1][pos] = init_huffman(bit_stream, nodes, size);
-    return pos;
-}
-
 static bstr decode_huffman(const bstr &input, const size_t target_size)
 {
-    bstr output;
-    output.reserve(input.size() * 2);
-    io::MsbBitStream bit_stream(input);
-    u16 nodes[2][512];
-    auto size = 256;
-    auto root = init_huffman(bit_stream, nodes, size);
-    while (output.size() < target_size && !bit_stream.eof())
-    {
-        auto byte = root;
-        while (byte >= 256 && byte <= 511)
-            byte = nodes[bit_stream.read(1)][byte];
-        output += static_cast<const u8>(byte);
-    }
+    io::BitReader<io::BitOrder::Msb> input_reader(
+        input.get<u8>(), input.size());
+    const algo::pack::HuffmanTree tree(input_reader);
+    bstr output(target_size);
+    output.resize(algo::pack::decode_huffman(
+        tree, input_reader, output.get<u8>(), output.size()));
     return output;
 }
 
@@ -53,4 +32,5 @@ std::unique_ptr<io::File> ScrFileDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<ScrFileDecoder>("lilim/scr");
+static auto _ = dec::register_decoder<ScrFileDecoder>("lilim/scr")
+    .add_extension("scr");
@@ -76,4 +76,5 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
     return {"majiro/rc8", "majiro/rct"};
 }
 
-static auto _ = dec::register_decoder<ArcArchiveDecoder>("majiro/arc");
+static auto _ = dec::register_decoder<ArcArchiveDecoder>("majiro/arc")
+    .add_magic(magic);
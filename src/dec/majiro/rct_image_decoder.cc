@@ -214,4 +214,5 @@ res::Image RctImageDecoder::decode_impl(
     return output_image;
 }
 
-static auto _ = dec::register_decoder<RctImageDecoder>("majiro/rct");
+static auto _ = dec::register_decoder<RctImageDecoder>("majiro/rct")
+    .add_magic(magic);
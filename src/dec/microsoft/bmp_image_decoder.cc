@@ -48,7 +48,7 @@ static Header read_header(io::BaseByteStream &input_stream)
     h.data_offset = input_stream.read_le<u32>();
 
     auto header_size = input_stream.read_le<u32>();
-    io::MemoryStream header_stream(input_stream.read(header_size - 4));
+    io::MemoryStream header_stream(input_stream.read_slice(header_size - 4));
 
     h.width = header_stream.read_le<u32>();
     s32 height = header_stream.read_le<u32>();
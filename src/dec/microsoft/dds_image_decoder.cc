@@ -179,4 +179,5 @@ res::Image DdsImageDecoder::decode_impl(
     return *image;
 }
 
-static auto _ = dec::register_decoder<DdsImageDecoder>("microsoft/dds");
+static auto _ = dec::register_decoder<DdsImageDecoder>("microsoft/dds")
+    .add_magic(magic);
@@ -1,9 +1,10 @@
 #include "dec/minato_soft/pac_archive_decoder.h"
 #include "algo/locale.h"
+#include "algo/pack/huffman.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
+#include "err.h"
 #include "io/memory_stream.h"
-#include "io/msb_bit_stream.h"
 
 using namespace au;
 using namespace au::dec::minato_soft;
@@ -20,42 +21,17 @@ namespace
 
 static const bstr magic = "PAC\x00"_b;
 
-static int init_huffman(
-    io::BaseBitStream &bit_stream, u16 nodes[2][512], int &pos)
-{
-    if (bit_stream.read(1))
-    {
-        auto old_pos = pos;
-        pos++;
-        if (old_pos < 511)
-        {
-            nodes[0][old_pos] = init_huffman(bit_stream, nodes, pos);
-            nodes[1][old_pos] = init_huffman(bit_stream, nodes, pos);
-            return old_pos;
-        }
-        return -1;
-    }
-    return bit_stream.read(8);
-}
-
 static bstr decompress_table(const bstr &input, size_t output_size)
 {
+    io::BitReader<io::BitOrder::Msb> input_reader(
+        input.get<u8>(), input.size());
+    const algo::pack::HuffmanTree tree(input_reader);
     bstr output(output_size);
-    auto output_ptr = output.get<u8>();
-    auto output_end = output.end<const u8>();
-    io::MsbBitStream bit_stream(input);
-
-    u16 nodes[2][512];
-    auto pos = 256;
-    auto initial_pos = init_huffman(bit_stream, nodes, pos);
-
-    while (output_ptr < output_end)
+    if (algo::pack::decode_huffman(
+            tree, input_reader, output.get<u8>(), output.size())
+        != output_size)
     {
-        auto pos = initial_pos;
-        while (pos >= 256 && pos <= 511)
-            pos = nodes[bit_stream.read(1)][pos];
-
-        *output_ptr++ = pos;
+        throw err::EofError();
     }
     return output;
 }
@@ -106,7 +82,7 @@ std::unique_ptr<io::File> PacArchiveDecoder::read_file_impl(
     input_file.stream.seek(entry->offset);
     auto data = input_file.stream.read(entry->size_comp);
     if (entry->size_orig != entry->size_comp)
-        data = algo::pack::zlib_inflate(data);
+        data = algo::pack::zlib_inflate(data, entry->size_orig);
     return std::make_unique<io::File>(entry->path, data);
 }
 
@@ -115,4 +91,5 @@ std::vector<std::string> PacArchiveDecoder::get_linked_formats() const
     return {"minato-soft/fil"};
 }
 
-static auto _ = dec::register_decoder<PacArchiveDecoder>("minato-soft/pac");
+static auto _ = dec::register_decoder<PacArchiveDecoder>("minato-soft/pac")
+    .add_magic(magic);
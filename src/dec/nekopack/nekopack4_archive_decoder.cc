@@ -70,7 +70,7 @@ std::unique_ptr<io::File> Nekopack4ArchiveDecoder::read_file_impl(
             break;
     }
 
-    data = algo::pack::zlib_inflate(data);
+    data = algo::pack::zlib_inflate(data, size_orig);
     return std::make_unique<io::File>(entry->path, data);
 }
 
@@ -80,4 +80,5 @@ std::vector<std::string> Nekopack4ArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<Nekopack4ArchiveDecoder>(
-    "nekopack/nekopack4");
+    "nekopack/nekopack4")
+    .add_magic(magic);
@@ -3,6 +3,7 @@
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
 #include "err.h"
+#include "io/sub_stream.h"
 
 using namespace au;
 using namespace au::dec::nitroplus;
@@ -137,9 +138,31 @@ std::unique_ptr<io::File> NpaArchiveDecoder::read_file_impl(
         decrypt_file_data(*meta, *entry, data);
 
     if (meta->files_are_compressed)
-        data = algo::pack::zlib_inflate(data);
+        data = algo::pack::zlib_inflate(data, entry->size_orig);
 
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<NpaArchiveDecoder>("nitroplus/npa");
+std::unique_ptr<io::File> NpaArchiveDecoder::stream_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const dec::ArchiveMeta &m,
+    const dec::ArchiveEntry &e) const
+{
+    const auto meta = static_cast<const ArchiveMetaImpl*>(&m);
+    const auto entry = static_cast<const ArchiveEntryImpl*>(&e);
+    if (meta->files_are_encrypted)
+        return nullptr;
+
+    auto data_stream = std::make_unique<io::SubStream>(
+        input_file.stream, entry->offset, entry->size_comp);
+    if (!meta->files_are_compressed)
+        return std::make_unique<io::File>(entry->path, std::move(data_stream));
+    return std::make_unique<io::File>(
+        entry->path,
+        std::make_unique<algo::pack::ZlibInflateStream>(
+            std::move(data_stream), entry->size_orig));
+}
+
+static auto _ = dec::register_decoder<NpaArchiveDecoder>("nitroplus/npa")
+    .add_magic(magic);
@@ -26,6 +26,12 @@ namespace nitroplus {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const override;
 
+        std::unique_ptr<io::File> stream_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const override;
+
     private:
         PluginManager<std::shared_ptr<NpaPlugin>> plugin_manager;
     };
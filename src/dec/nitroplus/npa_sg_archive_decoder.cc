@@ -70,4 +70,5 @@ std::unique_ptr<io::File> NpaSgArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<NpaSgArchiveDecoder>("nitroplus/npa-sg");
+static auto _ = dec::register_decoder<NpaSgArchiveDecoder>("nitroplus/npa-sg")
+    .add_extension("npa");
@@ -40,7 +40,7 @@ std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
 
     io::MemoryStream table_stream(
         algo::pack::zlib_inflate(
-            input_file.stream.read(table_size_comp)));
+            input_file.stream.read_slice(table_size_comp), table_size_orig));
 
     auto meta = std::make_unique<ArchiveMeta>();
     auto file_data_offset = input_file.stream.tell();
@@ -69,9 +69,11 @@ std::unique_ptr<io::File> PakArchiveDecoder::read_file_impl(
     auto entry = static_cast<const ArchiveEntryImpl*>(&e);
     input_file.stream.seek(entry->offset);
     auto data = entry->compressed
-        ? algo::pack::zlib_inflate(input_file.stream.read(entry->size_comp))
+        ? algo::pack::zlib_inflate(
+            input_file.stream.read_slice(entry->size_comp), entry->size_orig)
         : input_file.stream.read(entry->size_orig);
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<PakArchiveDecoder>("nitroplus/pak");
+static auto _ = dec::register_decoder<PakArchiveDecoder>("nitroplus/pak")
+    .add_magic(magic);
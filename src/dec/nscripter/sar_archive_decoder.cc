@@ -47,4 +47,5 @@ std::unique_ptr<io::File> SarArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<SarArchiveDecoder>("nscripter/sar");
+static auto _ = dec::register_decoder<SarArchiveDecoder>("nscripter/sar")
+    .add_extension("sar");
@@ -106,4 +106,5 @@ res::Image SpbImageDecoder::decode_impl(
     return decode_image(width, height, bit_stream);
 }
 
-static auto _ = dec::register_decoder<SpbImageDecoder>("nscripter/spb");
+static auto _ = dec::register_decoder<SpbImageDecoder>("nscripter/spb")
+    .add_extension("bmp");
@@ -174,4 +174,5 @@ res::Image GimImageDecoder::decode_impl(
     return *read_image(input_file.stream, chunks[0x04], std::move(palette));
 }
 
-static auto _ = dec::register_decoder<GimImageDecoder>("playstation/gim");
+static auto _ = dec::register_decoder<GimImageDecoder>("playstation/gim")
+    .add_magic(magic);
@@ -120,4 +120,5 @@ res::Image PngImageDecoder::decode(
     return ::decode(logger, input_file, chunk_handler);
 }
 
-static auto _ = dec::register_decoder<PngImageDecoder>("png/png");
+static auto _ = dec::register_decoder<PngImageDecoder>("png/png")
+    .add_magic(magic);
@@ -90,4 +90,5 @@ std::unique_ptr<io::File> MgrArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<MgrArchiveDecoder>("propeller/mgr");
+static auto _ = dec::register_decoder<MgrArchiveDecoder>("propeller/mgr")
+    .add_extension("mgr");
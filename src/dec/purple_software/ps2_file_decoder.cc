@@ -87,4 +87,5 @@ std::unique_ptr<io::File> Ps2FileDecoder::decode_impl(
     return std::make_unique<io::File>(input_file.path, data);
 }
 
-static auto _ = dec::register_decoder<Ps2FileDecoder>("purple-software/ps2");
+static auto _ = dec::register_decoder<Ps2FileDecoder>("purple-software/ps2")
+    .add_magic(magic);
@@ -50,4 +50,5 @@ res::Image DpngImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<DpngImageDecoder>("qlie/dpng");
+static auto _ = dec::register_decoder<DpngImageDecoder>("qlie/dpng")
+    .add_magic(magic);
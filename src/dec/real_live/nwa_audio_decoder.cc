@@ -1,4 +1,5 @@
 #include "dec/real_live/nwa_audio_decoder.h"
+#include "algo/parallel.h"
 #include "algo/range.h"
 #include "err.h"
 #include "io/lsb_bit_stream.h"
@@ -25,24 +26,30 @@ namespace
     };
 }
 
-static bstr decode_block(
+// decoding many short files in parallel is already handled by the unpacker,
+// so only long tracks get split across threads
+static const size_t min_parallel_batch_size = 256 * 1024;
+
+static void decode_block(
     const NwaHeader &header,
-    size_t current_block,
-    io::BaseByteStream &input_stream,
-    const std::vector<u32> &offsets)
+    const size_t current_block,
+    const bslice &input_data,
+    const std::vector<u32> &offsets,
+    u8 *output_ptr)
 {
     const auto bytes_per_sample = header.bits_per_sample >> 3;
-    const auto current_block_size = current_block != header.block_count - 1
-        ? header.block_size * bytes_per_sample
-        : header.rest_size * bytes_per_sample;
-    const auto output_size = current_block_size / bytes_per_sample;
-    const auto input_size = current_block != offsets.size() - 1
-        ? offsets.at(current_block + 1) - offsets.at(current_block)
-        : input_stream.size() - offsets.at(current_block);
-
-    io::MemoryStream output_stream(output_size);
-
-    input_stream.seek(offsets.at(current_block));
+    const auto output_size = current_block != header.block_count - 1
+        ? header.block_size
+        : header.rest_size;
+    const auto input_start = offsets.at(current_block);
+    const auto input_end = current_block != offsets.size() - 1
+        ? offsets.at(current_block + 1)
+        : input_data.size();
+    if (input_start > input_end || input_end > input_data.size())
+        throw err::BadDataOffsetError();
+
+    io::MemoryStream input_stream(
+        input_data.substr(input_start, input_end - input_start));
     s16 d[2];
     for (const auto i : algo::range(header.channel_count))
     {
@@ -52,9 +59,7 @@ static bstr decode_block(
             d[i] = input_stream.read_le<u16>();
     }
 
-    const auto input = input_stream.read(
-        input_size - bytes_per_sample * header.channel_count);
-    io::LsbBitStream bit_stream(input);
+    io::LsbBitStream bit_stream(input_stream.read_to_eof());
 
     auto current_channel = 0;
     auto run_length = 0;
@@ -124,19 +129,24 @@ static bstr decode_block(
         }
 
         if (header.bits_per_sample == 8)
-            output_stream.write<u8>(d[current_channel]);
+        {
+            *output_ptr++ = d[current_channel];
+        }
         else
-            output_stream.write_le<u16>(d[current_channel]);
+        {
+            *output_ptr++ = d[current_channel];
+            *output_ptr++ = d[current_channel] >> 8;
+        }
 
         if (header.channel_count == 2)
             current_channel ^= 1;
     }
-
-    return output_stream.seek(0).read_to_eof();
 }
 
 static bstr read_compressed_samples(
-    io::BaseByteStream &input_stream, const NwaHeader &header)
+    io::BaseByteStream &input_stream,
+    const bslice &input_data,
+    const NwaHeader &header)
 {
     if (header.compression_level < 0 || header.compression_level > 5)
         throw err::NotSupportedError("Unsupported compression level");
@@ -170,9 +180,30 @@ static bstr read_compressed_samples(
     for (const auto i : algo::range(header.block_count))
         offsets.push_back(input_stream.read_le<u32>());
 
-    bstr output;
-    for (const auto i : algo::range(header.block_count))
-        output += decode_block(header, i, input_stream, offsets);
+    // blocks are independent, so each of them can be decoded straight into
+    // its place in the output
+    bstr output(header.uncompressed_size);
+    const auto block_output_size
+        = header.block_size * (header.bits_per_sample >> 3);
+    const auto blocks_per_batch = std::max<size_t>(
+        1, min_parallel_batch_size / std::max<size_t>(1, block_output_size));
+    const auto batch_count
+        = (header.block_count + blocks_per_batch - 1) / blocks_per_batch;
+    algo::parallel_for(batch_count, [&](const size_t batch)
+    {
+        const auto first_block = batch * blocks_per_batch;
+        const auto last_block = std::min(
+            first_block + blocks_per_batch, header.block_count);
+        for (const auto i : algo::range(first_block, last_block))
+        {
+            decode_block(
+                header,
+                i,
+                input_data,
+                offsets,
+                output.get<u8>() + i * block_output_size);
+        }
+    });
     return output;
 }
 
@@ -191,7 +222,8 @@ res::Audio NwaAudioDecoder::decode_impl(
     const Logger &logger, io::File &input_file) const
 {
     // buffer the file in memory for performance
-    io::MemoryStream input_stream(input_file.stream.seek(0).read_to_eof());
+    const bslice input_data(input_file.stream.seek(0).read_to_eof());
+    io::MemoryStream input_stream(input_data);
 
     NwaHeader header;
     header.channel_count = input_stream.read_le<u16>();
@@ -208,7 +240,7 @@ res::Audio NwaAudioDecoder::decode_impl(
 
     const auto samples = header.compression_level == -1
         ? read_uncompressed_samples(input_stream, header)
-        : read_compressed_samples(input_stream, header);
+        : read_compressed_samples(input_stream, input_data, header);
 
     res::Audio audio;
     audio.channel_count = header.channel_count;
@@ -218,4 +250,5 @@ res::Audio NwaAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<NwaAudioDecoder>("real-live/nwa");
+static auto _ = dec::register_decoder<NwaAudioDecoder>("real-live/nwa")
+    .add_extension("nwa");
@@ -51,4 +51,5 @@ std::unique_ptr<io::File> OvkArchiveDecoder::read_file_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<OvkArchiveDecoder>("real-live/ovk");
+static auto _ = dec::register_decoder<OvkArchiveDecoder>("real-live/ovk")
+    .add_extension("ovk");
@@ -1,16 +1,73 @@
 #include "dec/registry.h"
 #include <algorithm>
+#include <array>
 #include <map>
+#include <mutex>
+#include <unordered_map>
+#include "algo/str.h"
 #include "dec/idecoder.h"
 #include "err.h"
+#include "io/file.h"
 
+using namespace au;
 using namespace au::dec;
 
+namespace
+{
+    struct MagicIndexEntry final
+    {
+        bstr magic;
+        std::string name;
+    };
+
+    // signatures placed at the same offset, bucketed by their first byte
+    struct MagicIndex final
+    {
+        size_t max_magic_size = 0;
+        std::array<std::vector<MagicIndexEntry>, 256> buckets;
+    };
+}
+
+static std::string normalize_extension(const std::string &extension)
+{
+    auto ret = algo::lower(extension);
+    while (!ret.empty() && ret[0] == '.')
+        ret.erase(0, 1);
+    return ret;
+}
+
 struct Registry::Priv final
 {
     std::map<std::string, DecoderCreator> decoder_map;
+    std::set<std::string> names_with_signatures;
+    std::map<size_t, MagicIndex> magic_indices;
+    std::unordered_map<std::string, std::vector<std::string>> extension_index;
+
+    std::mutex shared_decoders_mutex;
+    std::map<std::string, std::shared_ptr<const IDecoder>> shared_decoders;
 };
 
+DecoderSignature DecoderSignature::from_magic(
+    const bstr &magic, const size_t offset)
+{
+    if (magic.empty())
+        throw std::logic_error("Magic signature cannot be empty");
+    DecoderSignature signature;
+    signature.offset = offset;
+    signature.magic = magic;
+    return signature;
+}
+
+DecoderSignature DecoderSignature::from_extension(const std::string &extension)
+{
+    if (extension.empty())
+        throw std::logic_error("Extension signature cannot be empty");
+    DecoderSignature signature;
+    signature.offset = 0;
+    signature.extension = extension;
+    return signature;
+}
+
 Registry::Registry() : p(new Priv)
 {
 }
@@ -41,6 +98,18 @@ std::shared_ptr<IDecoder>
     return p->decoder_map[name]();
 }
 
+std::shared_ptr<const IDecoder>
+    Registry::get_decoder(const std::string &name) const
+{
+    std::unique_lock<std::mutex> lock(p->shared_decoders_mutex);
+    const auto it = p->shared_decoders.find(name);
+    if (it != p->shared_decoders.end())
+        return it->second;
+    const auto decoder = create_decoder(name);
+    p->shared_decoders[name] = decoder;
+    return decoder;
+}
+
 void Registry::add_decoder(const std::string &name, DecoderCreator creator)
 {
     if (has_decoder(name))
@@ -51,6 +120,72 @@ void Registry::add_decoder(const std::string &name, DecoderCreator creator)
     p->decoder_map[name] = creator;
 }
 
+void Registry::add_signature(
+    const std::string &name, const DecoderSignature &signature)
+{
+    if (!has_decoder(name))
+    {
+        throw std::logic_error(
+            "Decoder with name " + name + " was not registered.");
+    }
+
+    p->names_with_signatures.insert(name);
+    if (!signature.magic.empty())
+    {
+        auto &index = p->magic_indices[signature.offset];
+        index.max_magic_size
+            = std::max(index.max_magic_size, signature.magic.size());
+        index.buckets[signature.magic[0]].push_back({signature.magic, name});
+    }
+    if (!signature.extension.empty())
+    {
+        p->extension_index[normalize_extension(signature.extension)]
+            .push_back(name);
+    }
+}
+
+std::set<std::string> Registry::get_plausible_decoder_names(
+    io::File &input_file, const std::set<std::string> &decoder_names) const
+{
+    std::set<std::string> matching_names;
+
+    const auto extension_it = p->extension_index.find(
+        normalize_extension(input_file.path.extension()));
+    if (extension_it != p->extension_index.end())
+    {
+        matching_names.insert(
+            extension_it->second.begin(), extension_it->second.end());
+    }
+
+    const auto old_pos = input_file.stream.tell();
+    for (const auto &it : p->magic_indices)
+    {
+        const auto offset = it.first;
+        const auto &index = it.second;
+        if (offset >= input_file.stream.size())
+            continue;
+        input_file.stream.seek(offset);
+        const auto header = input_file.stream.read(
+            std::min(input_file.stream.left(), index.max_magic_size));
+        for (const auto &entry : index.buckets[header[0]])
+            if (header.substr(0, entry.magic.size()) == entry.magic)
+                matching_names.insert(entry.name);
+    }
+    input_file.stream.seek(old_pos);
+
+    std::set<std::string> ret;
+    for (const auto &name : decoder_names)
+    {
+        if (p->names_with_signatures.find(name)
+                == p->names_with_signatures.end()
+            || matching_names.find(name) != matching_names.end())
+        {
+            ret.insert(name);
+        }
+    }
+    return ret;
+}
+
 Registry &Registry::instance()
 {
     static Registry instance;
@@ -61,3 +196,23 @@ std::unique_ptr<Registry> Registry::create_mock()
 {
     return std::unique_ptr<Registry>(new Registry());
 }
+
+DecoderRegistration::DecoderRegistration(
+    Registry &registry, const std::string &name)
+    : registry(registry), name(name)
+{
+}
+
+DecoderRegistration &DecoderRegistration::add_magic(
+    const bstr &magic, const size_t offset)
+{
+    registry.add_signature(name, DecoderSignature::from_magic(magic, offset));
+    return *this;
+}
+
+DecoderRegistration &DecoderRegistration::add_extension(
+    const std::string &extension)
+{
+    registry.add_signature(name, DecoderSignature::from_extension(extension));
+    return *this;
+}
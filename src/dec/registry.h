@@ -2,13 +2,31 @@
 
 #include <functional>
 #include <memory>
+#include <set>
 #include <vector>
+#include "types.h"
 
 namespace au {
+namespace io { class File; }
 namespace dec {
 
     class IDecoder;
 
+    // Static hint about which files a decoder can possibly recognize. If a
+    // decoder declares any signatures, files that match none of them are
+    // never handed to its is_recognized().
+    struct DecoderSignature final
+    {
+        static DecoderSignature from_magic(
+            const bstr &magic, const size_t offset = 0);
+
+        static DecoderSignature from_extension(const std::string &extension);
+
+        size_t offset;
+        bstr magic;
+        std::string extension;
+    };
+
     class Registry final
     {
     private:
@@ -25,6 +43,21 @@ namespace dec {
         void add_decoder(const std::string &name, DecoderCreator creator);
         std::shared_ptr<IDecoder> create_decoder(const std::string &name) const;
 
+        // Returns a shared instance that is constructed only once. It is
+        // never configured with command line options, so it's only suitable
+        // for recognition and inspecting linked formats.
+        std::shared_ptr<const IDecoder> get_decoder(
+            const std::string &name) const;
+
+        void add_signature(
+            const std::string &name, const DecoderSignature &signature);
+
+        // Narrows given decoder names to these whose signatures match the
+        // input file. Decoders without signatures are always kept.
+        std::set<std::string> get_plausible_decoder_names(
+            io::File &input_file,
+            const std::set<std::string> &decoder_names) const;
+
     private:
         Registry();
 
@@ -32,12 +65,27 @@ namespace dec {
         std::unique_ptr<Priv> p;
     };
 
-    template <typename T, typename ...Params> bool register_decoder(
-        const std::string &name, Params&&... params)
+    class DecoderRegistration final
+    {
+    public:
+        DecoderRegistration(Registry &registry, const std::string &name);
+
+        DecoderRegistration &add_magic(
+            const bstr &magic, const size_t offset = 0);
+
+        DecoderRegistration &add_extension(const std::string &extension);
+
+    private:
+        Registry &registry;
+        std::string name;
+    };
+
+    template <typename T, typename ...Params> DecoderRegistration
+        register_decoder(const std::string &name, Params&&... params)
     {
         Registry::instance().add_decoder(
             name, [=]() { return std::make_shared<T>(params...); });
-        return true;
+        return DecoderRegistration(Registry::instance(), name);
     }
 
 } }
@@ -63,4 +63,5 @@ std::vector<std::string> PacArchiveDecoder::get_linked_formats() const
     return {"riddle-soft/cmp"};
 }
 
-static auto _ = dec::register_decoder<PacArchiveDecoder>("riddle-soft/pac");
+static auto _ = dec::register_decoder<PacArchiveDecoder>("riddle-soft/pac")
+    .add_magic(magic);
@@ -49,4 +49,5 @@ std::unique_ptr<io::File> Rgss3aArchiveDecoder::read_file_impl(
         input_file, *static_cast<const rgs::ArchiveEntryImpl*>(&e));
 }
 
-static auto _ = dec::register_decoder<Rgss3aArchiveDecoder>("rpgmaker/rgss3a");
+static auto _ = dec::register_decoder<Rgss3aArchiveDecoder>("rpgmaker/rgss3a")
+    .add_magic(magic);
@@ -24,4 +24,5 @@ res::Image PmpImageDecoder::decode_impl(
 }
 
 static auto _
-    = dec::register_decoder<PmpImageDecoder>("scene-player/pmp");
+    = dec::register_decoder<PmpImageDecoder>("scene-player/pmp")
+    .add_extension("pmp");
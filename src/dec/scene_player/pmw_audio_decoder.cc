@@ -22,4 +22,5 @@ std::unique_ptr<io::File> PmwAudioDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<PmwAudioDecoder>("scene-player/pmw");
+static auto _ = dec::register_decoder<PmwAudioDecoder>("scene-player/pmw")
+    .add_extension("pmw");
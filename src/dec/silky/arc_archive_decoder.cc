@@ -27,7 +27,7 @@ std::unique_ptr<dec::ArchiveMeta> ArcArchiveDecoder::read_meta_impl(
 {
     input_file.stream.seek(0);
     const auto table_size = input_file.stream.read_le<u32>();
-    io::MemoryStream table_stream(input_file.stream.read(table_size));
+    io::MemoryStream table_stream(input_file.stream.read_slice(table_size));
 
     auto meta = std::make_unique<ArchiveMeta>();
     while (!table_stream.eof())
@@ -64,4 +64,5 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
     return {"silky/akb"};
 }
 
-static auto _ = dec::register_decoder<ArcArchiveDecoder>("silky/arc");
+static auto _ = dec::register_decoder<ArcArchiveDecoder>("silky/arc")
+    .add_extension("arc");
@@ -60,4 +60,5 @@ std::vector<std::string> PakArchiveDecoder::get_linked_formats() const
     return {"sysadv/pga"};
 }
 
-static auto _ = dec::register_decoder<PakArchiveDecoder>("sysadv/pak");
+static auto _ = dec::register_decoder<PakArchiveDecoder>("sysadv/pak")
+    .add_magic(magic);
@@ -69,4 +69,5 @@ std::unique_ptr<io::File> PackdatArchiveDecoder::read_file_impl(
 }
 
 static auto _
-    = dec::register_decoder<PackdatArchiveDecoder>("system-epsilon/packdat");
+    = dec::register_decoder<PackdatArchiveDecoder>("system-epsilon/packdat")
+    .add_magic(magic);
@@ -132,4 +132,5 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
     return {"microsoft/dds"};
 }
 
-static auto _ = dec::register_decoder<ArcArchiveDecoder>("tactics/arc");
+static auto _ = dec::register_decoder<ArcArchiveDecoder>("tactics/arc")
+    .add_magic(magic);
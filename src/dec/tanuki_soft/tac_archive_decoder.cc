@@ -128,7 +128,7 @@ std::unique_ptr<io::File> TacArchiveDecoder::read_file_impl(
         .seek(entry->offset)
         .read(entry->size_compressed);
     if (entry->compressed)
-        data = algo::pack::zlib_inflate(data);
+        data = algo::pack::zlib_inflate(data, entry->size_original);
 
     if (!entry->compressed)
     {
@@ -236,4 +236,5 @@ std::unique_ptr<io::File> AnmArchiveDecoder::read_file_impl(
 }
 
 static auto _ = dec::register_decoder<AnmArchiveDecoder>(
-    "team-shanghai-alice/anm");
+    "team-shanghai-alice/anm")
+    .add_extension("anm");
@@ -84,4 +84,5 @@ std::vector<std::string> Pbg4ArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<Pbg4ArchiveDecoder>(
-    "team-shanghai-alice/pbg4");
+    "team-shanghai-alice/pbg4")
+    .add_magic(magic);
@@ -89,4 +89,5 @@ res::Image TfbmImageDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<TfbmImageDecoder>(
-    "twilight-frontier/tfbm");
+    "twilight-frontier/tfbm")
+    .add_magic(magic);
@@ -57,4 +57,5 @@ std::unique_ptr<io::File> TfcsFileDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<TfcsFileDecoder>(
-    "twilight-frontier/tfcs");
+    "twilight-frontier/tfcs")
+    .add_magic(magic);
@@ -447,4 +447,5 @@ std::vector<std::string> TfpkArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<TfpkArchiveDecoder>(
-    "twilight-frontier/tfpk");
+    "twilight-frontier/tfpk")
+    .add_magic(magic);
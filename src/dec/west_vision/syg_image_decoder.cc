@@ -20,4 +20,5 @@ res::Image SygImageDecoder::decode_impl(
     return res::Image(width, height, data, res::PixelFormat::BGR888);
 }
 
-static auto _ = dec::register_decoder<SygImageDecoder>("west-vision/syg");
+static auto _ = dec::register_decoder<SygImageDecoder>("west-vision/syg")
+    .add_magic(magic);
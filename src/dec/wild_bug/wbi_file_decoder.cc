@@ -23,4 +23,5 @@ std::unique_ptr<io::File> WbiFileDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<WbiFileDecoder>("wild-bug/wbi");
+static auto _ = dec::register_decoder<WbiFileDecoder>("wild-bug/wbi")
+    .add_magic(magic);
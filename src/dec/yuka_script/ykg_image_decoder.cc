@@ -109,4 +109,5 @@ res::Image YkgImageDecoder::decode_impl(
     return decode_png(logger, input_file, *header);
 }
 
-static auto _ = dec::register_decoder<YkgImageDecoder>("yuka-script/ykg");
+static auto _ = dec::register_decoder<YkgImageDecoder>("yuka-script/ykg")
+    .add_magic(magic);
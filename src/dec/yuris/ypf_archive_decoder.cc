@@ -153,4 +153,5 @@ std::unique_ptr<io::File> YpfArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<YpfArchiveDecoder>("yuris/ypf");
+static auto _ = dec::register_decoder<YpfArchiveDecoder>("yuris/ypf")
+    .add_magic(magic);
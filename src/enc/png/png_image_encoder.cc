@@ -1,5 +1,8 @@
 #include "enc/png/png_image_encoder.h"
-#include <png.h>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+#include "algo/parallel.h"
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_stream.h"
@@ -7,15 +10,244 @@
 using namespace au;
 using namespace au::enc::png;
 
-static void write_handler(
-    png_structp png_ptr, png_bytep input, png_size_t size)
+static const bstr png_magic = "\x89PNG\x0D\x0A\x1A\x0A"_b;
+static const int bpp = 4;
+
+// amount of filtered data deflated by a single thread
+static const size_t segment_size = 128 * 1024;
+static const size_t max_dictionary_size = 32 * 1024;
+
+// smaller images are encoded on the calling thread, as starting threads
+// would take longer than the work itself; larger ones use whatever is left
+// of the process-wide thread budget, and the output doesn't depend on it
+static const size_t min_parallel_size = 8 * segment_size;
+
+namespace
+{
+    enum FilterType : u8
+    {
+        FilterNone = 0,
+        FilterSub = 1,
+        FilterUp = 2,
+        FilterAverage = 3,
+        FilterPaeth = 4,
+    };
+
+    struct Settings final
+    {
+        bool adaptive_filtering;
+        int compression_level;
+        int memory_level;
+    };
+
+    struct Segment final
+    {
+        size_t first_row;
+        size_t last_row;
+        bstr data;
+        u32 checksum;
+    };
+}
+
+static Settings get_settings(const PngProfile profile)
+{
+    if (profile == PngProfile::Fastest)
+        return {false, 1, 8};
+    if (profile == PngProfile::Balanced)
+        return {true, 6, 8};
+    if (profile == PngProfile::Smallest)
+        return {true, 9, 9};
+    throw std::logic_error("Bad PNG profile");
+}
+
+static u8 paeth_predictor(const u8 a, const u8 b, const u8 c)
+{
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+static void filter_row(
+    const FilterType filter_type,
+    const u8 *row,
+    const u8 *prev_row,
+    const size_t size,
+    u8 *output)
+{
+    for (const auto i : algo::range(size))
+    {
+        const u8 a = i >= bpp ? row[i - bpp] : 0;
+        const u8 b = prev_row[i];
+        const u8 c = i >= bpp ? prev_row[i - bpp] : 0;
+        u8 prediction = 0;
+        if (filter_type == FilterSub)
+            prediction = a;
+        else if (filter_type == FilterUp)
+            prediction = b;
+        else if (filter_type == FilterAverage)
+            prediction = (a + b) >> 1;
+        else if (filter_type == FilterPaeth)
+            prediction = paeth_predictor(a, b, c);
+        output[i] = row[i] - prediction;
+    }
+}
+
+// the usual "minimum sum of absolute differences" heuristic
+static size_t get_filter_cost(const u8 *output, const size_t size)
+{
+    size_t cost = 0;
+    for (const auto i : algo::range(size))
+        cost += output[i] < 0x80 ? output[i] : 0x100 - output[i];
+    return cost;
+}
+
+static void convert_row(const res::Image &image, const size_t y, u8 *output)
+{
+    const auto *pixel = &image.at(0, y);
+    for (const auto x : algo::range(image.width()))
+    {
+        *output++ = pixel->r;
+        *output++ = pixel->g;
+        *output++ = pixel->b;
+        *output++ = pixel->a;
+        pixel++;
+    }
+}
+
+static void filter_segment(
+    const res::Image &image,
+    const Settings &settings,
+    const Segment &segment,
+    u8 *output)
+{
+    const auto stride = image.width() * bpp;
+    bstr row(stride), prev_row(stride), candidate(stride), best(stride);
+    if (segment.first_row)
+        convert_row(image, segment.first_row - 1, prev_row.get<u8>());
+
+    for (const auto y : algo::range(segment.first_row, segment.last_row))
+    {
+        convert_row(image, y, row.get<u8>());
+        auto filter_type = FilterNone;
+        std::memcpy(best.get<u8>(), row.get<u8>(), stride);
+        if (settings.adaptive_filtering)
+        {
+            auto best_cost = get_filter_cost(best.get<u8>(), stride);
+            for (const auto type : {
+                FilterSub, FilterUp, FilterAverage, FilterPaeth})
+            {
+                filter_row(
+                    type,
+                    row.get<u8>(),
+                    prev_row.get<u8>(),
+                    stride,
+                    candidate.get<u8>());
+                const auto cost
+                    = get_filter_cost(candidate.get<u8>(), stride);
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    filter_type = type;
+                    std::swap(best, candidate);
+                }
+            }
+        }
+        *output++ = filter_type;
+        std::memcpy(output, best.get<u8>(), stride);
+        output += stride;
+        std::swap(row, prev_row);
+    }
+}
+
+static bstr deflate_segment(
+    const Settings &settings,
+    const u8 *input,
+    const size_t input_size,
+    const size_t dictionary_size,
+    const bool is_last)
+{
+    z_stream s;
+    std::memset(&s, 0, sizeof(s));
+    const auto ret = deflateInit2(
+        &s,
+        settings.compression_level,
+        Z_DEFLATED,
+        -MAX_WBITS,
+        settings.memory_level,
+        Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK)
+        throw std::logic_error("Failed to initialize zlib stream");
+
+    // segments are deflated separately, but they can still refer to the
+    // data of the previous segments
+    if (dictionary_size)
+    {
+        deflateSetDictionary(
+            &s, input - dictionary_size, dictionary_size);
+    }
+
+    // segments except the last end on a byte boundary without marking
+    // the final block, so they can simply be concatenated
+    const auto flush = is_last ? Z_FINISH : Z_SYNC_FLUSH;
+    bstr output(deflateBound(&s, input_size) + 16);
+    s.next_in = const_cast<Bytef*>(input);
+    s.avail_in = input_size;
+    s.next_out = output.get<Bytef>();
+    s.avail_out = output.size();
+    while (true)
+    {
+        const auto ret = deflate(&s, flush);
+        if (ret == Z_STREAM_ERROR)
+        {
+            deflateEnd(&s);
+            throw std::logic_error("Failed to deflate PNG data");
+        }
+        if (s.avail_out && (!is_last || ret == Z_STREAM_END))
+            break;
+        const auto pos = s.total_out;
+        output.resize(output.size() * 2);
+        s.next_out = output.get<Bytef>() + pos;
+        s.avail_out = output.size() - pos;
+    }
+    output.resize(s.total_out);
+    deflateEnd(&s);
+    return output;
+}
+
+static bstr make_zlib_header(const int compression_level)
+{
+    const u8 cmf = 0x78; // deflate with 32K window
+    const u8 level
+        = compression_level < 2 ? 0
+        : compression_level < 6 ? 1
+        : compression_level == 6 ? 2
+        : 3;
+    u8 flg = level << 6;
+    flg += 31 - ((cmf << 8) | flg) % 31;
+    return io::MemoryStream().write<u8>(cmf).write<u8>(flg)
+        .seek(0).read_to_eof();
+}
+
+static void write_chunk(
+    io::BaseByteStream &output_stream,
+    const bstr &type,
+    const bstr &data)
 {
-    auto output_stream
-        = reinterpret_cast<io::BaseByteStream*>(png_get_io_ptr(png_ptr));
-    output_stream->write(bstr(input, size));
+    auto crc = crc32(0, type.get<const Bytef>(), type.size());
+    // crc32() treats a null buffer as a request for the initial value
+    if (!data.empty())
+        crc = crc32(crc, data.get<const Bytef>(), data.size());
+    output_stream.write_be<u32>(data.size());
+    output_stream.write(type);
+    output_stream.write(data);
+    output_stream.write_be<u32>(crc);
 }
 
-static void flush_handler(png_structp)
+PngImageEncoder::PngImageEncoder(const PngProfile profile) : profile(profile)
 {
 }
 
@@ -24,44 +256,81 @@ void PngImageEncoder::encode_impl(
     const res::Image &input_image,
     io::File &output_file) const
 {
-    png_structp png_ptr = png_create_write_struct(
-        PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-    if (!png_ptr)
-        throw std::logic_error("Failed to create PNG write structure");
-
-    png_infop info_ptr = png_create_info_struct(png_ptr);
-    if (!info_ptr)
-        throw std::logic_error("Failed to create PNG info structure");
-
     const auto width = input_image.width();
     const auto height = input_image.height();
     if (!width || !height)
         throw err::BadDataSizeError();
-    const auto bpp = 4;
-    const auto color_type = PNG_COLOR_TYPE_RGBA;
-    int transformations = PNG_TRANSFORM_BGR;
-
-    png_set_IHDR(
-        png_ptr, info_ptr, width, height, 8, color_type,
-        PNG_INTERLACE_NONE,
-        PNG_COMPRESSION_TYPE_BASE,
-        PNG_FILTER_TYPE_BASE);
-
-    // 0 = no compression, 9 = max compression
-    // 1 produces good file size and is still fast.
-    png_set_filter(png_ptr, 0, PNG_FILTER_NONE);
-    png_set_compression_level(png_ptr, 1);
-
-    png_set_write_fn(
-        png_ptr, &output_file.stream, &write_handler, &flush_handler);
-    png_write_info(png_ptr, info_ptr);
-
-    auto rows = std::make_unique<const u8*[]>(height);
-    for (const auto y : algo::range(height))
-        rows.get()[y] = reinterpret_cast<const u8*>(&input_image.at(0, y));
-    png_set_rows(png_ptr, info_ptr, const_cast<u8**>(rows.get()));
-    png_write_png(png_ptr, info_ptr, transformations, nullptr);
-    png_destroy_write_struct(&png_ptr, &info_ptr);
+
+    const auto settings = get_settings(profile);
+    const auto filtered_stride = width * bpp + 1;
+    const auto rows_per_segment
+        = std::max<size_t>(1, segment_size / filtered_stride);
+
+    std::vector<Segment> segments;
+    for (const auto y : algo::range(0, height, rows_per_segment))
+    {
+        Segment segment;
+        segment.first_row = y;
+        segment.last_row = std::min<size_t>(height, y + rows_per_segment);
+        segments.push_back(segment);
+    }
+
+    // filtering needs raw previous rows and deflating needs filtered
+    // previous data, hence two passes
+    bstr filtered(filtered_stride * height);
+    const size_t thread_count = filtered.size() >= min_parallel_size ? 0 : 1;
+    algo::parallel_for(segments.size(), [&](const size_t i)
+    {
+        filter_segment(
+            input_image,
+            settings,
+            segments[i],
+            filtered.get<u8>() + segments[i].first_row * filtered_stride);
+    }, thread_count);
+
+    algo::parallel_for(segments.size(), [&](const size_t i)
+    {
+        auto &segment = segments[i];
+        const auto offset = segment.first_row * filtered_stride;
+        const auto size
+            = (segment.last_row - segment.first_row) * filtered_stride;
+        const auto input = filtered.get<const u8>() + offset;
+        segment.data = deflate_segment(
+            settings,
+            input,
+            size,
+            std::min(offset, max_dictionary_size),
+            i == segments.size() - 1);
+        segment.checksum = adler32(adler32(0, nullptr, 0), input, size);
+    }, thread_count);
+
+    auto checksum = segments[0].checksum;
+    for (const auto i : algo::range(1, segments.size()))
+    {
+        const auto size = (segments[i].last_row - segments[i].first_row)
+            * filtered_stride;
+        checksum = adler32_combine(checksum, segments[i].checksum, size);
+    }
+    segments.front().data = make_zlib_header(settings.compression_level)
+        + segments.front().data;
+    segments.back().data += io::MemoryStream().write_be<u32>(checksum)
+        .seek(0).read_to_eof();
+
+    io::MemoryStream header_stream;
+    header_stream.write_be<u32>(width);
+    header_stream.write_be<u32>(height);
+    header_stream.write<u8>(8); // bit depth
+    header_stream.write<u8>(6); // RGBA
+    header_stream.write<u8>(0); // deflate
+    header_stream.write<u8>(0); // adaptive filtering
+    header_stream.write<u8>(0); // no interlacing
+
+    auto &output_stream = output_file.stream;
+    output_stream.write(png_magic);
+    write_chunk(output_stream, "IHDR"_b, header_stream.seek(0).read_to_eof());
+    for (const auto &segment : segments)
+        write_chunk(output_stream, "IDAT"_b, segment.data);
+    write_chunk(output_stream, "IEND"_b, ""_b);
 
     output_file.path.change_extension("png");
 }
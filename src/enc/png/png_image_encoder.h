@@ -6,13 +6,29 @@ namespace au {
 namespace enc {
 namespace png {
 
+    enum class PngProfile : u8
+    {
+        Fastest  = 0, // no filtering, fastest deflate
+        Balanced = 1, // adaptive filtering, default deflate
+        Smallest = 2, // adaptive filtering, best deflate
+    };
+
+    // Splits the image into row segments that are filtered and deflated
+    // independently across threads, and joins them into a single IDAT
+    // stream, similarly to pigz.
     class PngImageEncoder final : public BaseImageEncoder
     {
+    public:
+        PngImageEncoder(const PngProfile profile = PngProfile::Fastest);
+
     protected:
         void encode_impl(
             const Logger &logger,
             const res::Image &input_image,
             io::File &output_file) const override;
+
+    private:
+        PngProfile profile;
     };
 
 } } }
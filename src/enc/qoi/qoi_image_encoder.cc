@@ -0,0 +1,114 @@
+#include "enc/qoi/qoi_image_encoder.h"
+
+using namespace au;
+using namespace au::enc::qoi;
+
+static const bstr magic = "qoif"_b;
+static const bstr end_marker = "\x00\x00\x00\x00\x00\x00\x00\x01"_b;
+
+static const u8 op_index = 0x00;
+static const u8 op_diff = 0x40;
+static const u8 op_luma = 0x80;
+static const u8 op_run = 0xC0;
+static const u8 op_rgb = 0xFE;
+static const u8 op_rgba = 0xFF;
+static const size_t max_run = 62;
+
+static size_t get_hash(const res::Pixel &pixel)
+{
+    return (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+}
+
+void QoiImageEncoder::encode_impl(
+    const Logger &logger,
+    const res::Image &input_image,
+    io::File &output_file) const
+{
+    output_file.stream.write(magic);
+    output_file.stream.write_be<u32>(input_image.width());
+    output_file.stream.write_be<u32>(input_image.height());
+    output_file.stream.write<u8>(4); // RGBA
+    output_file.stream.write<u8>(0); // sRGB with linear alpha
+
+    // no pixel takes more than 5 bytes, so the chunks can be written
+    // without any bounds checks
+    const auto pixel_count = input_image.width() * input_image.height();
+    bstr output(pixel_count * 5);
+    auto output_ptr = output.get<u8>();
+
+    res::Pixel index[64] = {};
+    res::Pixel prev = {0, 0, 0, 0xFF};
+    size_t run = 0;
+    for (const auto &pixel : input_image)
+    {
+        if (pixel == prev)
+        {
+            if (++run == max_run)
+            {
+                *output_ptr++ = op_run | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run)
+        {
+            *output_ptr++ = op_run | (run - 1);
+            run = 0;
+        }
+
+        const auto hash = get_hash(pixel);
+        if (index[hash] == pixel)
+        {
+            *output_ptr++ = op_index | hash;
+        }
+        else if (pixel.a != prev.a)
+        {
+            index[hash] = pixel;
+            *output_ptr++ = op_rgba;
+            *output_ptr++ = pixel.r;
+            *output_ptr++ = pixel.g;
+            *output_ptr++ = pixel.b;
+            *output_ptr++ = pixel.a;
+        }
+        else
+        {
+            index[hash] = pixel;
+            const s8 dr = pixel.r - prev.r;
+            const s8 dg = pixel.g - prev.g;
+            const s8 db = pixel.b - prev.b;
+            const s8 dr_dg = dr - dg;
+            const s8 db_dg = db - dg;
+            if (dr >= -2 && dr <= 1
+                && dg >= -2 && dg <= 1
+                && db >= -2 && db <= 1)
+            {
+                *output_ptr++ = op_diff
+                    | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+            }
+            else if (dg >= -32 && dg <= 31
+                && dr_dg >= -8 && dr_dg <= 7
+                && db_dg >= -8 && db_dg <= 7)
+            {
+                *output_ptr++ = op_luma | (dg + 32);
+                *output_ptr++ = ((dr_dg + 8) << 4) | (db_dg + 8);
+            }
+            else
+            {
+                *output_ptr++ = op_rgb;
+                *output_ptr++ = pixel.r;
+                *output_ptr++ = pixel.g;
+                *output_ptr++ = pixel.b;
+            }
+        }
+        prev = pixel;
+    }
+    if (run)
+        *output_ptr++ = op_run | (run - 1);
+
+    output.resize(output_ptr - output.get<u8>());
+    output_file.stream.write(output);
+    output_file.stream.write(end_marker);
+
+    output_file.path.change_extension("qoi");
+}
@@ -0,0 +1,25 @@
+#include "enc/raw/bgra_image_encoder.h"
+
+using namespace au;
+using namespace au::enc::raw;
+
+static const bstr magic = "BGRA"_b;
+static const size_t header_size = 16;
+
+void BgraImageEncoder::encode_impl(
+    const Logger &logger,
+    const res::Image &input_image,
+    io::File &output_file) const
+{
+    output_file.stream.write(magic);
+    output_file.stream.write_le<u32>(header_size);
+    output_file.stream.write_le<u32>(input_image.width());
+    output_file.stream.write_le<u32>(input_image.height());
+
+    // res::Pixel is laid out as BGRA already
+    const auto data = reinterpret_cast<const u8*>(input_image.begin());
+    const auto size = input_image.width() * input_image.height() * 4;
+    output_file.stream.write(bstr(data, size));
+
+    output_file.path.change_extension("bgra");
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "enc/base_image_encoder.h"
+
+namespace au {
+namespace enc {
+namespace raw {
+
+    // Writes a 16-byte header followed by uncompressed BGRA pixels, so that
+    // the output can be memory-mapped and used as is.
+    class BgraImageEncoder final : public BaseImageEncoder
+    {
+    protected:
+        void encode_impl(
+            const Logger &logger,
+            const res::Image &input_image,
+            io::File &output_file) const override;
+    };
+
+} } }
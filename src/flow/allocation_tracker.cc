@@ -0,0 +1,105 @@
+#include "flow/allocation_tracker.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+    // GetProcessMemoryInfo from kernel32 rather than psapi.dll
+    #define PSAPI_VERSION 2
+    #include <malloc.h>
+    #include <windows.h>
+    #include <psapi.h>
+#elif defined(__APPLE__)
+    #include <malloc/malloc.h>
+    #include <sys/resource.h>
+#else
+    #include <malloc.h>
+    #include <sys/resource.h>
+#endif
+
+using namespace au;
+using namespace au::flow;
+
+static thread_local AllocationCounters *current_counters = nullptr;
+
+// the allocator's own idea of the size, so that it is known when freeing
+static size_t get_allocated_size(void *ptr)
+{
+    #ifdef _WIN32
+        return _msize(ptr);
+    #elif defined(__APPLE__)
+        return malloc_size(ptr);
+    #else
+        return malloc_usable_size(ptr);
+    #endif
+}
+
+// the other forms of new and delete forward to these by default
+void *operator new(std::size_t size)
+{
+    const auto ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    if (const auto counters = current_counters)
+    {
+        const auto allocated_size = get_allocated_size(ptr);
+        ++counters->allocation_count;
+        counters->allocated_bytes += allocated_size;
+        counters->live_bytes += allocated_size;
+        if (counters->live_bytes > static_cast<s64>(counters->peak_live_bytes))
+            counters->peak_live_bytes = counters->live_bytes;
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (ptr && current_counters)
+        current_counters->live_bytes -= get_allocated_size(ptr);
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+AllocationScope::AllocationScope(const bool enabled) :
+    enabled(enabled),
+    previous_counters(current_counters)
+{
+    if (enabled)
+        current_counters = &counters;
+}
+
+AllocationScope::~AllocationScope()
+{
+    if (enabled)
+        current_counters = previous_counters;
+}
+
+const AllocationCounters &AllocationScope::get_counters() const
+{
+    return counters;
+}
+
+size_t flow::get_peak_resident_memory()
+{
+    #ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS memory_counters;
+        if (!GetProcessMemoryInfo(
+            GetCurrentProcess(), &memory_counters, sizeof(memory_counters)))
+        {
+            return 0;
+        }
+        return memory_counters.PeakWorkingSetSize;
+    #else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage))
+            return 0;
+        #ifdef __APPLE__
+            return usage.ru_maxrss;
+        #else
+            return usage.ru_maxrss * 1024;
+        #endif
+    #endif
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "types.h"
+
+namespace au {
+namespace flow {
+
+    struct AllocationCounters final
+    {
+        size_t allocation_count = 0;
+        size_t allocated_bytes = 0;
+
+        // memory freed within the scope may come from outside of it, so
+        // this can go below zero
+        s64 live_bytes = 0;
+        size_t peak_live_bytes = 0;
+    };
+
+    // Counts the memory allocated with operator new by the current thread
+    // for as long as the scope exists. When scopes are nested, only the
+    // innermost one counts. Without any enabled scope, allocations aren't
+    // tracked and cost nothing extra.
+    class AllocationScope final
+    {
+    public:
+        AllocationScope(const bool enabled = true);
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope &) = delete;
+        AllocationScope &operator =(const AllocationScope &) = delete;
+
+        const AllocationCounters &get_counters() const;
+
+    private:
+        const bool enabled;
+        AllocationCounters counters;
+        AllocationCounters *previous_counters;
+    };
+
+    // the most physical memory the process has used so far
+    size_t get_peak_resident_memory();
+
+} }
@@ -1,13 +1,23 @@
 #include "flow/cli_facade.h"
 #include <algorithm>
+#include <cctype>
+#include <limits>
 #include <map>
+#include <set>
+#include "algo/parallel.h"
 #include "algo/range.h"
 #include "algo/str.h"
 #include "arg_parser.h"
 #include "dec/idecoder.h"
 #include "dec/registry.h"
+#include "enc/png/png_image_encoder.h"
+#include "enc/qoi/qoi_image_encoder.h"
+#include "enc/raw/bgra_image_encoder.h"
+#include "err.h"
+#include "flow/allocation_tracker.h"
 #include "flow/file_saver_hdd.h"
 #include "flow/parallel_unpacker.h"
+#include "io/file_stream.h"
 #include "io/file_system.h"
 #include "version.h"
 #include "virtual_file_system.h"
@@ -30,7 +40,86 @@ namespace
         bool should_list_decoders;
         int verbosity = 3;
         unsigned int thread_count;
+        size_t max_memory;
+        std::string image_format;
+        enc::png::PngProfile png_profile;
+        bool should_print_stats;
+        io::path stats_json_path;
+        io::path trace_path;
     };
+
+    // keeps the directories of the input files searchable for companion
+    // files while they're being unpacked
+    class DirectoryRegistrations final
+    {
+    public:
+        DirectoryRegistrations(const std::vector<io::path> &input_paths);
+        ~DirectoryRegistrations();
+
+    private:
+        std::set<io::path> directories;
+    };
+}
+
+DirectoryRegistrations::DirectoryRegistrations(
+    const std::vector<io::path> &input_paths)
+{
+    for (const auto &input_path : input_paths)
+        directories.insert(io::absolute(input_path).parent());
+    for (const auto &directory : directories)
+        VirtualFileSystem::register_directory(directory);
+}
+
+DirectoryRegistrations::~DirectoryRegistrations()
+{
+    for (const auto &directory : directories)
+        VirtualFileSystem::unregister_directory(directory);
+}
+
+// accepts sizes in bytes as well as "512M", "2G" and similar
+static size_t parse_memory_size(const std::string &input)
+{
+    static const std::map<char, size_t> units
+        {
+            {'K', 1024ull},
+            {'M', 1024ull * 1024},
+            {'G', 1024ull * 1024 * 1024},
+        };
+    auto digits = input;
+    size_t unit = 1;
+    if (!digits.empty())
+    {
+        const auto it = units.find(std::toupper(digits.back()));
+        if (it != units.end())
+        {
+            unit = it->second;
+            digits.pop_back();
+        }
+    }
+    if (digits.empty())
+        throw err::UsageError("Invalid memory size: " + input);
+    const auto max_number = std::numeric_limits<size_t>::max() / unit;
+    size_t number = 0;
+    for (const auto c : digits)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(c)))
+            throw err::UsageError("Invalid memory size: " + input);
+        const size_t digit = c - '0';
+        if (number > (max_number - digit) / 10)
+            throw err::UsageError("Memory size is too large: " + input);
+        number = number * 10 + digit;
+    }
+    return number * unit;
+}
+
+static std::unique_ptr<enc::BaseImageEncoder> create_image_encoder(
+    const Options &options)
+{
+    if (options.image_format == "qoi")
+        return std::make_unique<enc::qoi::QoiImageEncoder>();
+    if (options.image_format == "bgra")
+        return std::make_unique<enc::raw::BgraImageEncoder>();
+    return std::make_unique<enc::png::PngImageEncoder>(options.png_profile);
 }
 
 struct CliFacade::Priv final
@@ -180,6 +269,46 @@ void CliFacade::Priv::register_cli_options()
             ->hide_possible_values();
     }
 
+    arg_parser.register_switch({"--max-memory"})
+        ->set_value_name("SIZE")
+        ->set_description(
+            "Limits memory taken by files waiting to be processed, such as "
+            "nested archives, e.g. 512M or 2G. Above the limit, archives "
+            "are unpacked more slowly and large files are kept in a "
+            "temporary directory.");
+
+    arg_parser.register_switch({"--image-format"})
+        ->set_value_name("FORMAT")
+        ->set_description("Sets output image format (defaults to png).")
+        ->add_possible_value("png", "Portable Network Graphics")
+        ->add_possible_value("qoi", "Quite OK Image, faster than PNG")
+        ->add_possible_value(
+            "bgra", "Uncompressed BGRA pixels after a 16-byte header");
+
+    arg_parser.register_switch({"--png-profile"})
+        ->set_value_name("PROFILE")
+        ->set_description(
+            "Trades PNG encoding speed for file size "
+            "(defaults to fastest).")
+        ->add_possible_value("fastest")
+        ->add_possible_value("balanced")
+        ->add_possible_value("smallest");
+
+    arg_parser.register_flag({"--stats"})
+        ->set_description(
+            "Prints how much time and memory each decoder spent on "
+            "recognition, reading, decoding, encoding and saving.");
+
+    arg_parser.register_switch({"--stats-json"})
+        ->set_value_name("PATH")
+        ->set_description("Writes the same statistics to a JSON file.");
+
+    arg_parser.register_switch({"--trace"})
+        ->set_value_name("PATH")
+        ->set_description(
+            "Writes a timeline of the work of each thread to a JSON file "
+            "that can be opened in chrome://tracing or Perfetto.");
+
     arg_parser.register_flag({"--no-color", "--no-colors"})
         ->set_description("Disables colors in console output.");
 
@@ -231,6 +360,30 @@ void CliFacade::Priv::parse_cli_options()
     if (arg_parser.has_flag("--no-vfs"))
         VirtualFileSystem::disable();
 
+    options.max_memory = arg_parser.has_switch("--max-memory")
+        ? parse_memory_size(arg_parser.get_switch("--max-memory"))
+        : 0;
+
+    options.image_format = arg_parser.has_switch("--image-format")
+        ? arg_parser.get_switch("--image-format")
+        : "png";
+
+    const std::map<std::string, enc::png::PngProfile> png_profiles
+        {
+            {"fastest", enc::png::PngProfile::Fastest},
+            {"balanced", enc::png::PngProfile::Balanced},
+            {"smallest", enc::png::PngProfile::Smallest},
+        };
+    options.png_profile = arg_parser.has_switch("--png-profile")
+        ? png_profiles.at(arg_parser.get_switch("--png-profile"))
+        : enc::png::PngProfile::Fastest;
+
+    options.should_print_stats = arg_parser.has_flag("--stats");
+    if (arg_parser.has_switch("--stats-json"))
+        options.stats_json_path = arg_parser.get_switch("--stats-json");
+    if (arg_parser.has_switch("--trace"))
+        options.trace_path = arg_parser.get_switch("--trace");
+
     if (arg_parser.has_switch("-o"))
         options.output_dir = arg_parser.get_switch("-o");
     else if (arg_parser.has_switch("--out"))
@@ -291,13 +444,22 @@ int CliFacade::Priv::run() const
         : std::set<std::string>{options.decoder};
 
     FileSaverHdd file_saver(options.output_dir, options.overwrite);
+    const auto image_encoder = create_image_encoder(options);
+    const auto collect_stats = options.should_print_stats
+        || !options.stats_json_path.str().empty();
+    UnpackingStats stats;
+    TraceRecorder trace;
     ParallelUnpackerContext context(
         logger,
         file_saver,
         registry,
         options.enable_nested_decoding,
         arguments,
-        available_decoders);
+        available_decoders,
+        *image_encoder,
+        options.max_memory,
+        collect_stats ? &stats : nullptr,
+        options.trace_path.str().empty() ? nullptr : &trace);
 
     ParallelUnpacker unpacker(context);
     for (const auto &input_path : options.input_paths)
@@ -306,13 +468,39 @@ int CliFacade::Priv::run() const
             io::path(input_path).change_stem(input_path.stem() + "~").name(),
             [&]()
             {
-                VirtualFileSystem::register_directory(
-                    io::absolute(input_path).parent());
                 return std::make_shared<io::File>(
                     io::absolute(input_path), io::FileMode::Read);
             });
     }
-    return unpacker.run(options.thread_count) ? 0 : 1;
+    // decoders and encoders going parallel share the workers' threads
+    algo::set_thread_budget(options.thread_count);
+    const auto result = [&]()
+    {
+        const DirectoryRegistrations registrations(options.input_paths);
+        return unpacker.run(options.thread_count);
+    }();
+
+    if (options.should_print_stats)
+    {
+        logger.log(
+            Logger::MessageType::Summary, "%s", stats.format_table().c_str());
+        logger.log(
+            Logger::MessageType::Summary,
+            "Peak resident memory: %.01f MiB\n",
+            get_peak_resident_memory() / 1024.0 / 1024.0);
+    }
+    if (!options.stats_json_path.str().empty())
+    {
+        io::FileStream(options.stats_json_path, io::FileMode::Write)
+            .write(bstr(stats.format_json()));
+    }
+    if (!options.trace_path.str().empty())
+    {
+        io::FileStream(options.trace_path, io::FileMode::Write)
+            .write(bstr(trace.format_json()));
+    }
+
+    return result ? 0 : 1;
 }
 
 CliFacade::CliFacade(Logger &logger, const std::vector<std::string> &arguments)
@@ -1,4 +1,6 @@
 #include "flow/file_saver_hdd.h"
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <set>
 #include "algo/format.h"
@@ -8,7 +10,7 @@
 using namespace au;
 using namespace au::flow;
 
-static std::mutex mutex;
+static const size_t chunk_size = 1024 * 1024;
 
 struct FileSaverHdd::Priv final
 {
@@ -17,11 +19,17 @@ struct FileSaverHdd::Priv final
         const bool overwrite);
 
     io::path make_path_unique(const io::path &path);
+    void create_directories(const io::path &path);
 
     io::path output_dir;
     bool overwrite;
-    size_t saved_file_count;
+    std::atomic<size_t> saved_file_count;
+
+    std::mutex paths_mutex;
     std::set<io::path> paths;
+
+    std::mutex directories_mutex;
+    std::set<io::path> created_directories;
 };
 
 FileSaverHdd::Priv::Priv(const io::path &output_dir, const bool overwrite)
@@ -31,6 +39,7 @@ FileSaverHdd::Priv::Priv(const io::path &output_dir, const bool overwrite)
 
 io::path FileSaverHdd::Priv::make_path_unique(const io::path &path)
 {
+    std::unique_lock<std::mutex> lock(paths_mutex);
     io::path new_path = path;
     int i = 1;
     while (paths.find(new_path) != paths.end()
@@ -42,6 +51,15 @@ io::path FileSaverHdd::Priv::make_path_unique(const io::path &path)
     return new_path;
 }
 
+void FileSaverHdd::Priv::create_directories(const io::path &path)
+{
+    std::unique_lock<std::mutex> lock(directories_mutex);
+    if (created_directories.find(path) != created_directories.end())
+        return;
+    io::create_directories(path);
+    created_directories.insert(path);
+}
+
 FileSaverHdd::FileSaverHdd(
     const io::path &output_dir, const bool overwrite)
     : p(new Priv(output_dir, overwrite))
@@ -54,11 +72,28 @@ FileSaverHdd::~FileSaverHdd()
 
 io::path FileSaverHdd::save(std::shared_ptr<io::File> file) const
 {
-    std::unique_lock<std::mutex> lock(mutex);
+    // only choosing the target path needs to be serialized - once it's
+    // reserved, the file can be written concurrently with other files
     const auto full_path = p->make_path_unique(p->output_dir / file->path);
-    io::create_directories(full_path.parent());
-    io::FileStream output_stream(full_path, io::FileMode::Write);
-    output_stream.write(file->stream.seek(0).read_to_eof());
+    p->create_directories(full_path.parent());
+    try
+    {
+        // copy in chunks so that streamed files don't get read as a whole
+        io::FileStream output_stream(full_path, io::FileMode::Write);
+        file->stream.seek(0);
+        while (!file->stream.eof())
+        {
+            output_stream.write(file->stream.read(
+                std::min<size_t>(file->stream.left(), chunk_size)));
+        }
+    }
+    catch (...)
+    {
+        // a failed cleanup mustn't hide the original error
+        boost::system::error_code ec;
+        io::remove(full_path, ec);
+        throw;
+    }
     ++p->saved_file_count;
     return full_path;
 }
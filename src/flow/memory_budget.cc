@@ -0,0 +1,162 @@
+#include "flow/memory_budget.h"
+#include <atomic>
+#include <mutex>
+#include "io/file_system.h"
+#include "io/memory_stream.h"
+
+using namespace au;
+using namespace au::flow;
+
+// small files are not worth the trouble of writing them to disk
+static const size_t min_spill_size = 64 * 1024;
+static const size_t spill_chunk_size = 1024 * 1024;
+
+// shared with the held files, which can outlive the budget itself
+struct MemoryBudget::Priv final
+{
+    struct HeldFile final
+    {
+        ~HeldFile();
+
+        std::shared_ptr<io::File> file;
+        std::shared_ptr<Priv> budget;
+        size_t size;
+        io::path spill_path;
+    };
+
+    Priv(const size_t max_memory);
+    ~Priv();
+
+    io::path make_spill_path();
+
+    const size_t max_memory;
+    std::atomic<size_t> used_memory;
+
+    std::mutex spill_mutex;
+    io::path spill_directory;
+};
+
+MemoryBudget::Priv::Priv(const size_t max_memory)
+    : max_memory(max_memory), used_memory(0)
+{
+}
+
+MemoryBudget::Priv::~Priv()
+{
+    // whatever couldn't be removed is left for the system to clean up
+    boost::system::error_code ec;
+    if (!spill_directory.str().empty())
+        io::remove_all(spill_directory, ec);
+}
+
+io::path MemoryBudget::Priv::make_spill_path()
+{
+    std::unique_lock<std::mutex> lock(spill_mutex);
+    if (spill_directory.str().empty())
+    {
+        spill_directory = io::unique_path(
+            io::temporary_directory() / "arc_unpacker-%%%%-%%%%-%%%%");
+        io::create_directories(spill_directory);
+    }
+    return io::unique_path(spill_directory / "%%%%-%%%%-%%%%-%%%%.tmp");
+}
+
+MemoryBudget::Priv::HeldFile::~HeldFile()
+{
+    budget->used_memory -= size;
+    if (!spill_path.str().empty())
+    {
+        // clones of the mapped file may still be open, in which case some
+        // systems refuse to delete it; ~Priv gets another chance
+        file.reset();
+        boost::system::error_code ec;
+        io::remove(spill_path, ec);
+    }
+}
+
+static void spill(io::File &input_file, const io::path &spill_path)
+{
+    io::File output_file(spill_path, io::FileMode::Write);
+    input_file.stream.seek(0);
+    while (input_file.stream.left())
+    {
+        output_file.stream.write(input_file.stream.read(
+            std::min(spill_chunk_size, input_file.stream.left())));
+    }
+}
+
+MemoryBudget::MemoryBudget(const size_t max_memory)
+    : p(std::make_shared<Priv>(max_memory))
+{
+}
+
+MemoryBudget::~MemoryBudget()
+{
+}
+
+size_t MemoryBudget::get_max_memory() const
+{
+    return p->max_memory;
+}
+
+size_t MemoryBudget::get_used_memory() const
+{
+    return p->used_memory;
+}
+
+bool MemoryBudget::is_exceeded() const
+{
+    return p->max_memory && p->used_memory > p->max_memory;
+}
+
+std::shared_ptr<io::File> MemoryBudget::hold(
+    const Logger &logger,
+    const std::shared_ptr<io::File> file,
+    const bool allow_spilling)
+{
+    // other streams either read from disk or decode on the fly
+    if (!p->max_memory || !dynamic_cast<io::MemoryStream*>(&file->stream))
+        return file;
+
+    auto held_file = std::make_shared<Priv::HeldFile>();
+    held_file->budget = p;
+    held_file->size = 0;
+
+    const auto size = file->stream.size();
+    if (allow_spilling
+        && size >= min_spill_size
+        && p->used_memory + size > p->max_memory)
+    {
+        io::path spill_path;
+        try
+        {
+            spill_path = p->make_spill_path();
+            spill(*file, spill_path);
+            held_file->file = std::make_shared<io::File>(
+                spill_path, io::FileMode::Read);
+            held_file->file->path = file->path;
+            held_file->spill_path = spill_path;
+        }
+        catch (const std::exception &e)
+        {
+            // a full disk shouldn't stop the unpacking, only slow it down
+            logger.warn(
+                "failed to move file to disk, keeping it in memory (%s)\n",
+                e.what());
+            held_file->file.reset();
+            boost::system::error_code ec;
+            if (!spill_path.str().empty())
+                io::remove(spill_path, ec);
+        }
+    }
+
+    if (!held_file->file)
+    {
+        file->stream.seek(0);
+        held_file->file = file;
+        held_file->size = size;
+        p->used_memory += size;
+    }
+
+    return std::shared_ptr<io::File>(held_file, held_file->file.get());
+}
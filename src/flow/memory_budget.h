@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include "io/file.h"
+#include "logger.h"
+
+namespace au {
+namespace flow {
+
+    // Keeps track of the memory taken by files that wait between the
+    // unpacking stages. Files that don't fit in the budget can be moved to
+    // a temporary directory on disk, which is removed once the last of them
+    // is released.
+    class MemoryBudget final
+    {
+    public:
+        // 0 means no limit
+        MemoryBudget(const size_t max_memory);
+        ~MemoryBudget();
+
+        size_t get_max_memory() const;
+        size_t get_used_memory() const;
+        bool is_exceeded() const;
+
+        // Accounts for the file for as long as the returned pointer (or any
+        // of its copies) lives. When allowed and the file doesn't fit, it
+        // is spilled to disk and the returned file reads from there; if
+        // that fails, the file stays in memory and a warning is logged.
+        std::shared_ptr<io::File> hold(
+            const Logger &logger,
+            const std::shared_ptr<io::File> file,
+            const bool allow_spilling);
+
+    private:
+        struct Priv;
+        std::shared_ptr<Priv> p;
+    };
+
+} }
@@ -1,7 +1,6 @@
 #include "flow/parallel_decoder_adapter.h"
 #include "algo/naming_strategies.h"
 #include "enc/microsoft/wav_audio_encoder.h"
-#include "enc/png/png_image_encoder.h"
 #include "flow/vfs_bridge.h"
 
 using namespace au;
@@ -9,8 +8,11 @@ using namespace au::flow;
 
 ParallelDecoderAdapter::ParallelDecoderAdapter(
     const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
-    const std::shared_ptr<io::File> input_file)
-    : parent_task(parent_task), input_file(input_file)
+    const std::shared_ptr<io::File> input_file,
+    const std::string &decoder_name) :
+        parent_task(parent_task),
+        input_file(input_file),
+        decoder_name(decoder_name)
 {
 }
 
@@ -21,8 +23,16 @@ ParallelDecoderAdapter::~ParallelDecoderAdapter()
 void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
 {
     auto input_file = this->input_file;
+    const StatsMeasurement measurement(
+        parent_task->task_context.unpacker_context.stats);
     auto meta = std::shared_ptr<dec::ArchiveMeta>(
         decoder.read_meta(parent_task->logger, *input_file));
+    parent_task->task_context.add_stats(
+        decoder_name,
+        StatsStage::ReadMeta,
+        measurement,
+        input_file->stream.size(),
+        0);
     parent_task->logger.info(
         "archive contains %d files.\n", meta->entries.size());
 
@@ -40,10 +50,13 @@ void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
             [meta, &entry, &decoder, vfs_bridge]
             (io::File &input_file_copy, const Logger &logger)
             {
-                return decoder.read_file(
+                DecodedOutputFile output;
+                output.file = decoder.stream_file(
                     logger, input_file_copy, *meta, *entry);
+                return output;
             },
             decoder,
+            decoder_name,
             entry->path.str());
     }
 }
@@ -54,22 +67,36 @@ void ParallelDecoderAdapter::visit(const dec::BaseFileDecoder &decoder)
         input_file,
         [&decoder](io::File &input_file_copy, const Logger &logger)
         {
-            return decoder.decode(logger, input_file_copy);
+            DecodedOutputFile output;
+            output.file = decoder.decode(logger, input_file_copy);
+            return output;
         },
-        decoder);
+        decoder,
+        decoder_name);
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseImageDecoder &decoder)
 {
+    const auto &encoder
+        = parent_task->task_context.unpacker_context.image_encoder;
     parent_task->save_file(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, &encoder](io::File &input_file_copy, const Logger &logger)
         {
-            auto output_file = decoder.decode(logger, input_file_copy);
-            const auto encoder = enc::png::PngImageEncoder();
-            return encoder.encode(logger, output_file, input_file_copy.path);
+            const auto image = std::make_shared<res::Image>(
+                decoder.decode(logger, input_file_copy));
+            const auto path = input_file_copy.path;
+            DecodedOutputFile output;
+            output.resource_size
+                = image->width() * image->height() * sizeof(res::Pixel);
+            output.encoder = [image, path, &encoder](const Logger &logger)
+            {
+                return encoder.encode(logger, *image, path);
+            };
+            return output;
         },
-        decoder);
+        decoder,
+        decoder_name);
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseAudioDecoder &decoder)
@@ -78,9 +105,18 @@ void ParallelDecoderAdapter::visit(const dec::BaseAudioDecoder &decoder)
         input_file,
         [&decoder](io::File &input_file_copy, const Logger &logger)
         {
-            auto output_file = decoder.decode(logger, input_file_copy);
-            const auto encoder = enc::microsoft::WavAudioEncoder();
-            return encoder.encode(logger, output_file, input_file_copy.path);
+            const auto audio = std::make_shared<res::Audio>(
+                decoder.decode(logger, input_file_copy));
+            const auto path = input_file_copy.path;
+            DecodedOutputFile output;
+            output.resource_size = audio->samples.size();
+            output.encoder = [audio, path](const Logger &logger)
+            {
+                const auto encoder = enc::microsoft::WavAudioEncoder();
+                return encoder.encode(logger, *audio, path);
+            };
+            return output;
         },
-        decoder);
+        decoder,
+        decoder_name);
 }
@@ -11,7 +11,8 @@ namespace flow {
     public:
         ParallelDecoderAdapter(
             const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
-            const std::shared_ptr<io::File> input_file);
+            const std::shared_ptr<io::File> input_file,
+            const std::string &decoder_name);
         ~ParallelDecoderAdapter();
 
         void visit(const dec::BaseArchiveDecoder &decoder) override;
@@ -22,6 +23,7 @@ namespace flow {
     private:
         const std::shared_ptr<const BaseParallelUnpackingTask> parent_task;
         const std::shared_ptr<io::File> input_file;
+        const std::string decoder_name;
     };
 
 } }
@@ -1,19 +1,28 @@
 #include "flow/parallel_unpacker.h"
 #include <chrono>
+#include <mutex>
 #include <set>
 #include <stack>
+#include <thread>
 #include "algo/format.h"
+#include "algo/pack/zlib.h"
 #include "dec/idecoder.h"
 #include "err.h"
 #include "flow/parallel_decoder_adapter.h"
+#include "io/memory_stream.h"
+#include "io/sub_stream.h"
 
 using namespace au;
 using namespace au::flow;
 
 static const auto max_depth = 10;
+static const size_t stage_count = 4;
 static int task_count = 0;
 static std::mutex mutex;
 
+// statistics of files that no decoder recognized
+static const std::string unrecognized_label = "(unrecognized)";
+
 namespace
 {
     struct DecodeInputFileTask final : public BaseParallelUnpackingTask
@@ -31,9 +40,9 @@ namespace
         const InputFileFactory file_factory;
     };
 
-    struct ProcessOutputFileTask final : public BaseParallelUnpackingTask
+    struct DecodeOutputFileTask final : public BaseParallelUnpackingTask
     {
-        ProcessOutputFileTask(
+        DecodeOutputFileTask(
             ParallelTaskContext &task_context,
             const TaskSourceType source_type,
             const io::path &base_name,
@@ -42,6 +51,7 @@ namespace
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory file_factory,
             const std::shared_ptr<const dec::IDecoder> origin_decoder,
+            const std::string &decoder_name,
             const std::string &target_name);
 
         bool work() const override;
@@ -49,35 +59,98 @@ namespace
         const std::shared_ptr<io::File> input_file;
         const DecoderFileFactory file_factory;
         const std::shared_ptr<const dec::IDecoder> origin_decoder;
+        const std::string decoder_name;
         const std::string target_name;
     };
+
+    // the stages below continue the work of the task that created them,
+    // so they share its logger and its place in the task tree
+
+    struct EncodeOutputFileTask final : public BaseParallelUnpackingTask
+    {
+        EncodeOutputFileTask(
+            const BaseParallelUnpackingTask &previous_stage,
+            const std::shared_ptr<io::File> input_file,
+            const OutputFileEncoder encoder,
+            const std::shared_ptr<const dec::IDecoder> origin_decoder,
+            const std::string &decoder_name,
+            const size_t resource_size);
+
+        bool work() const override;
+
+        const std::shared_ptr<io::File> input_file;
+        const OutputFileEncoder encoder;
+        const std::shared_ptr<const dec::IDecoder> origin_decoder;
+        const std::string decoder_name;
+        const size_t resource_size;
+    };
+
+    // marks the work of a task in the trace, if one is being recorded
+    struct TraceScope final
+    {
+        TraceScope(
+            const BaseParallelUnpackingTask &task,
+            const UnpackingStage stage,
+            const std::string &decoder_name,
+            const io::path &path);
+        ~TraceScope();
+
+        TraceRecorder *trace;
+        const std::string name;
+        TraceArguments end_arguments;
+    };
+
+    struct SaveFileTask final : public BaseParallelUnpackingTask
+    {
+        SaveFileTask(
+            const BaseParallelUnpackingTask &previous_stage,
+            const std::shared_ptr<io::File> file,
+            const std::string &decoder_name);
+
+        bool work() const override;
+
+        const std::shared_ptr<io::File> file;
+        const std::string decoder_name;
+    };
+}
+
+static std::string get_stage_name(const UnpackingStage stage)
+{
+    if (stage == UnpackingStage::Read)
+        return "read";
+    if (stage == UnpackingStage::Decode)
+        return "decode";
+    if (stage == UnpackingStage::Encode)
+        return "encode";
+    if (stage == UnpackingStage::Write)
+        return "write";
+    throw std::logic_error("Bad unpacking stage");
+}
+
+static int get_next_task_id()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return task_count++;
 }
 
 static bool save(
-    const BaseParallelUnpackingTask &task, std::shared_ptr<io::File> file)
+    const BaseParallelUnpackingTask &task,
+    std::shared_ptr<io::File> file,
+    const std::string &decoder_name)
 {
-    try
-    {
-        const auto full_path
-            = task.task_context.unpacker_context.file_saver.save(file);
-        task.logger.success("saved to %s\n", full_path.c_str());
-        task.logger.flush();
-        return true;
-    }
-    catch (const err::IoError &e)
-    {
-        task.logger.err(
-            "error saving (%s)\n", e.what() ? e.what() : "unknown error");
-        task.logger.flush();
-        return false;
-    }
+    const auto held_file = task.task_context.memory_budget.hold(
+        task.logger, file, false);
+    task.task_context.push(
+        UnpackingStage::Write,
+        std::make_shared<SaveFileTask>(task, held_file, decoder_name));
+    return true;
 }
 
 static std::set<std::string> collect_linked_decoders(
     const dec::IDecoder &base_decoder, const dec::Registry &registry)
 {
     std::set<std::string> known_formats;
-    std::vector<std::shared_ptr<dec::IDecoder>> linked_decoders;
+    std::vector<std::shared_ptr<const dec::IDecoder>> linked_decoders;
     std::stack<const dec::IDecoder*> decoders_to_inspect;
     decoders_to_inspect.push(&base_decoder);
     while (!decoders_to_inspect.empty())
@@ -89,7 +162,7 @@ static std::set<std::string> collect_linked_decoders(
             if (known_formats.find(format) != known_formats.end())
                 continue;
             known_formats.insert(format);
-            auto linked_decoder = registry.create_decoder(format);
+            auto linked_decoder = registry.get_decoder(format);
             decoders_to_inspect.push(linked_decoder.get());
             linked_decoders.push_back(std::move(linked_decoder));
         }
@@ -97,29 +170,42 @@ static std::set<std::string> collect_linked_decoders(
     return std::set<std::string>(known_formats.begin(), known_formats.end());
 }
 
-static std::shared_ptr<dec::IDecoder> guess_decoder(
+static std::string guess_decoder(
     const BaseParallelUnpackingTask &task,
     const std::set<std::string> &decoders_to_check,
     io::File &file,
     const TaskSourceType source_type)
 {
+    const auto &registry = task.task_context.unpacker_context.registry;
+    const auto plausible_decoders
+        = registry.get_plausible_decoder_names(file, decoders_to_check);
     task.logger.info(
-        "guessing decoder among %d decoders...\n", decoders_to_check.size());
+        "guessing decoder among %d decoders (%d plausible)...\n",
+        decoders_to_check.size(),
+        plausible_decoders.size());
 
-    std::map<std::string, std::shared_ptr<dec::IDecoder>> matching_decoders;
-    for (const auto &name : decoders_to_check)
+    std::set<std::string> matching_decoders;
+    for (const auto &name : plausible_decoders)
     {
-        const auto current_decoder
-            = task.task_context.unpacker_context.registry.create_decoder(name);
-        if (current_decoder->is_recognized(file))
-            matching_decoders[name] = std::move(current_decoder);
+        const auto decoder = registry.get_decoder(name);
+        const StatsMeasurement measurement(
+            task.task_context.unpacker_context.stats);
+        const auto is_recognized = decoder->is_recognized(file);
+        task.task_context.add_stats(
+            name,
+            StatsStage::Recognition,
+            measurement,
+            file.stream.size(),
+            0);
+        if (is_recognized)
+            matching_decoders.insert(name);
     }
 
     if (matching_decoders.size() == 1)
     {
         task.logger.success(
-            "recognized as %s.\n", matching_decoders.begin()->first.c_str());
-        return matching_decoders.begin()->second;
+            "recognized as %s.\n", matching_decoders.begin()->c_str());
+        return *matching_decoders.begin();
     }
 
     if (matching_decoders.empty())
@@ -132,7 +218,7 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
         {
             task.logger.err("not recognized by any decoder.\n");
         }
-        return nullptr;
+        return "";
     }
 
     if (source_type == TaskSourceType::NestedDecoding)
@@ -142,11 +228,100 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
     else
     {
         task.logger.warn("file was recognized by multiple decoders.\n");
-        for (const auto &it : matching_decoders)
-            task.logger.warn("- " + it.first + "\n");
+        for (const auto &name : matching_decoders)
+            task.logger.warn("- " + name + "\n");
         task.logger.warn("Please provide --dec and proceed manually.\n");
     }
-    return nullptr;
+    return "";
+}
+
+// archive entries that are read from the archive only as they're consumed
+static bool is_streamed(const io::File &file)
+{
+    return dynamic_cast<const io::SubStream*>(&file.stream)
+        || dynamic_cast<const algo::pack::ZlibInflateStream*>(&file.stream);
+}
+
+// reads streamed files into memory
+static std::shared_ptr<io::File> buffer_file(
+    const std::shared_ptr<io::File> file)
+{
+    if (dynamic_cast<io::MemoryStream*>(&file->stream))
+        return file;
+    file->stream.seek(0);
+    return std::make_shared<io::File>(file->path, file->stream.read_to_eof());
+}
+
+// names the final output file and either saves it or hands it over for
+// nested decoding
+static bool process_output_file(
+    const BaseParallelUnpackingTask &task,
+    const std::shared_ptr<io::File> output_file,
+    const dec::IDecoder &origin_decoder,
+    const std::string &decoder_name)
+{
+    const auto &unpacker_context = task.task_context.unpacker_context;
+    const auto naming_strategy = origin_decoder.naming_strategy();
+    output_file->path = algo::apply_naming_strategy(
+        naming_strategy, task.base_name, output_file->path);
+
+    if (!unpacker_context.enable_nested_decoding)
+        return save(task, output_file, decoder_name);
+
+    auto linked_decoders = collect_linked_decoders(
+        origin_decoder, unpacker_context.registry);
+    linked_decoders.insert(
+        task.decoders_to_check.begin(), task.decoders_to_check.end());
+
+    if (linked_decoders.empty())
+        return save(task, output_file, decoder_name);
+
+    if (task.get_depth() >= max_depth)
+    {
+        task.logger.warn("cycle detected.\n");
+        return save(task, output_file, decoder_name);
+    }
+
+    // recognition seeks back and forth, which would make streamed entries
+    // get decoded all over again, and the memory budget can only account
+    // for files that sit in memory
+    std::shared_ptr<io::File> buffered_file;
+    try
+    {
+        const StatsMeasurement measurement(
+            task.task_context.unpacker_context.stats);
+        buffered_file = buffer_file(output_file);
+        if (is_streamed(*output_file))
+        {
+            task.task_context.add_stats(
+                decoder_name,
+                StatsStage::ReadFile,
+                measurement,
+                0,
+                buffered_file->stream.size());
+        }
+    }
+    catch (const std::exception &e)
+    {
+        task.logger.err("error reading (%s)\n", e.what());
+        return false;
+    }
+
+    // nested files can wait in the queue for a long time, so these are the
+    // ones that get moved to disk when running out of memory
+    const auto held_file = task.task_context.memory_budget.hold(
+        task.logger, buffered_file, true);
+    task.task_context.push(
+        UnpackingStage::Read,
+        std::make_shared<DecodeInputFileTask>(
+            task.task_context,
+            TaskSourceType::NestedDecoding,
+            output_file->path,
+            task.shared_from_this(),
+            linked_decoders,
+            [=]() { return held_file; }));
+
+    return true;
 }
 
 ParallelUnpackerContext::ParallelUnpackerContext(
@@ -155,24 +330,56 @@ ParallelUnpackerContext::ParallelUnpackerContext(
     const dec::Registry &registry,
     const bool enable_nested_decoding,
     const std::vector<std::string> &arguments,
-    const std::set<std::string> &decoders_to_check) :
+    const std::set<std::string> &decoders_to_check,
+    const enc::BaseImageEncoder &image_encoder,
+    const size_t max_memory,
+    UnpackingStats *stats,
+    TraceRecorder *trace) :
         logger(logger),
         file_saver(file_saver),
         registry(registry),
         enable_nested_decoding(enable_nested_decoding),
         arguments(arguments),
-        decoders_to_check(decoders_to_check)
+        decoders_to_check(decoders_to_check),
+        image_encoder(image_encoder),
+        max_memory(max_memory),
+        stats(stats),
+        trace(trace)
 {
 }
 
 ParallelTaskContext::ParallelTaskContext(
     ParallelUnpacker &unpacker,
     const ParallelUnpackerContext &unpacker_context,
-    TaskScheduler &task_scheduler) :
+    Pipeline &pipeline,
+    dec::DecoderPool &decoder_pool,
+    MemoryBudget &memory_budget) :
         unpacker(unpacker),
         unpacker_context(unpacker_context),
-        task_scheduler(task_scheduler)
+        pipeline(pipeline),
+        decoder_pool(decoder_pool),
+        memory_budget(memory_budget)
+{
+}
+
+void ParallelTaskContext::push(
+    const UnpackingStage stage, std::shared_ptr<ITask> task) const
 {
+    pipeline.push_front(static_cast<size_t>(stage), std::move(task));
+}
+
+void ParallelTaskContext::add_stats(
+    const std::string &decoder_name,
+    const StatsStage stage,
+    const StatsMeasurement &measurement,
+    const size_t bytes_in,
+    const size_t bytes_out) const
+{
+    if (unpacker_context.stats)
+    {
+        unpacker_context.stats->add(
+            decoder_name, stage, measurement.finish(bytes_in, bytes_out));
+    }
 }
 
 BaseParallelUnpackingTask::BaseParallelUnpackingTask(
@@ -186,11 +393,9 @@ BaseParallelUnpackingTask::BaseParallelUnpackingTask(
         source_type(source_type),
         base_name(base_name),
         parent_task(parent_task),
-        decoders_to_check(decoders_to_check)
+        decoders_to_check(decoders_to_check),
+        task_id(get_next_task_id())
 {
-    mutex.lock();
-    const auto task_id = task_count++;
-    mutex.unlock();
     logger.set_prefix(
         algo::format("[task %d] %s: ", task_id, base_name.c_str()));
 }
@@ -211,10 +416,12 @@ void BaseParallelUnpackingTask::save_file(
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
     const dec::BaseDecoder &origin_decoder,
+    const std::string &decoder_name,
     const std::string &target_name) const
 {
-    task_context.task_scheduler.push_front(
-        std::make_shared<ProcessOutputFileTask>(
+    task_context.push(
+        UnpackingStage::Decode,
+        std::make_shared<DecodeOutputFileTask>(
             task_context,
             source_type,
             base_name,
@@ -224,6 +431,7 @@ void BaseParallelUnpackingTask::save_file(
             input_file,
             file_factory,
             origin_decoder.shared_from_this(),
+            decoder_name,
             target_name));
 }
 
@@ -244,8 +452,33 @@ DecodeInputFileTask::DecodeInputFileTask(
 {
 }
 
+TraceScope::TraceScope(
+    const BaseParallelUnpackingTask &task,
+    const UnpackingStage stage,
+    const std::string &decoder_name,
+    const io::path &path) :
+        trace(task.task_context.unpacker_context.trace),
+        name(get_stage_name(stage))
+{
+    if (!trace)
+        return;
+    TraceArguments arguments;
+    arguments["task"] = algo::format("%d", task.task_id);
+    arguments["path"] = path.str();
+    if (!decoder_name.empty())
+        arguments["decoder"] = decoder_name;
+    trace->begin(name, arguments);
+}
+
+TraceScope::~TraceScope()
+{
+    if (trace)
+        trace->end(name, end_arguments);
+}
+
 bool DecodeInputFileTask::work() const
 {
+    TraceScope trace_scope(*this, UnpackingStage::Read, "", base_name);
     std::shared_ptr<io::File> input_file;
     try
     {
@@ -266,25 +499,21 @@ bool DecodeInputFileTask::work() const
     {
         logger.info("initial recognition...\n");
 
-        const auto decoder = guess_decoder(
+        const auto decoder_name = guess_decoder(
             *this, decoders_to_check, *input_file, source_type);
+        trace_scope.end_arguments["decoder"] = decoder_name;
 
-        if (!decoder)
+        if (decoder_name.empty())
         {
             return source_type == TaskSourceType::NestedDecoding
-                ? save(*this, input_file)
+                ? save(*this, input_file, unrecognized_label)
                 : false;
         }
 
-        ArgParser decoder_arg_parser;
-        const auto decorators = decoder->get_arg_parser_decorators();
-        for (const auto &decorator : decorators)
-            decorator.register_cli_options(decoder_arg_parser);
-        decoder_arg_parser.parse(task_context.unpacker_context.arguments);
-        for (const auto &decorator : decorators)
-            decorator.parse_cli_options(decoder_arg_parser);
-
-        ParallelDecoderAdapter adapter(shared_from_this(), input_file);
+        const auto decoder
+            = task_context.decoder_pool.get_decoder(decoder_name);
+        ParallelDecoderAdapter adapter(
+            shared_from_this(), input_file, decoder_name);
         decoder->accept(adapter);
         return true;
     }
@@ -292,12 +521,12 @@ bool DecodeInputFileTask::work() const
     {
         logger.err("recognition finished with errors (%s)\n", e.what());
         if (source_type == TaskSourceType::NestedDecoding)
-            save(*this, input_file);
+            save(*this, input_file, unrecognized_label);
         return false;
     }
 }
 
-ProcessOutputFileTask::ProcessOutputFileTask(
+DecodeOutputFileTask::DecodeOutputFileTask(
     ParallelTaskContext &task_context,
     const TaskSourceType source_type,
     const io::path &base_name,
@@ -306,6 +535,7 @@ ProcessOutputFileTask::ProcessOutputFileTask(
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
     const std::shared_ptr<const dec::IDecoder> origin_decoder,
+    const std::string &decoder_name,
     const std::string &target_name) :
         BaseParallelUnpackingTask(
             task_context,
@@ -316,12 +546,18 @@ ProcessOutputFileTask::ProcessOutputFileTask(
         input_file(input_file),
         file_factory(file_factory),
         origin_decoder(origin_decoder),
+        decoder_name(decoder_name),
         target_name(target_name)
 {
 }
 
-bool ProcessOutputFileTask::work() const
+bool DecodeOutputFileTask::work() const
 {
+    TraceScope trace_scope(
+        *this,
+        UnpackingStage::Decode,
+        decoder_name,
+        target_name.empty() ? base_name : io::path(target_name));
     logger.info(
         target_name.empty()
             ? "decoding...\n"
@@ -334,11 +570,12 @@ bool ProcessOutputFileTask::work() const
     }
 
     io::File input_file_copy(*input_file);
-    std::shared_ptr<io::File> output_file;
+    DecodedOutputFile output;
+    const StatsMeasurement measurement(task_context.unpacker_context.stats);
     try
     {
-        output_file = file_factory(input_file_copy, logger);
-        if (!output_file)
+        output = file_factory(input_file_copy, logger);
+        if (!output.file && !output.encoder)
         {
             logger.info(
                 target_name.empty()
@@ -360,47 +597,154 @@ bool ProcessOutputFileTask::work() const
                 "error decoding \"%s\" (%s)\n", target_name.c_str(), e.what());
         }
         if (source_type == TaskSourceType::NestedDecoding)
-            save(*this, input_file);
+            save(*this, input_file, decoder_name);
         return false;
     }
 
+    // archive entries are read from the archive, other decoders take the
+    // whole input file
+    if (target_name.empty())
+    {
+        task_context.add_stats(
+            decoder_name,
+            StatsStage::Decode,
+            measurement,
+            input_file->stream.size(),
+            output.file ? output.file->stream.size() : output.resource_size);
+    }
+    else if (!output.file || !is_streamed(*output.file))
+    {
+        // streamed entries are only opened here and get charged once
+        // they're actually read
+        task_context.add_stats(
+            decoder_name,
+            StatsStage::ReadFile,
+            measurement,
+            0,
+            output.file ? output.file->stream.size() : output.resource_size);
+    }
+
     logger.info(
         target_name.empty()
             ? "decoding finished\n"
             : "decoding of \"%s\" finished.\n",
         target_name.c_str());
 
-    const auto naming_strategy = origin_decoder->naming_strategy();
-    output_file->path = algo::apply_naming_strategy(
-        naming_strategy, base_name, output_file->path);
-
-    if (!task_context.unpacker_context.enable_nested_decoding)
-        return save(*this, output_file);
+    if (output.encoder)
+    {
+        task_context.push(
+            UnpackingStage::Encode,
+            std::make_shared<EncodeOutputFileTask>(
+                *this,
+                input_file,
+                output.encoder,
+                origin_decoder,
+                decoder_name,
+                output.resource_size));
+        return true;
+    }
 
-    auto linked_decoders = collect_linked_decoders(
-        *origin_decoder, task_context.unpacker_context.registry);
-    linked_decoders.insert(
-        decoders_to_check.begin(), decoders_to_check.end());
+    return process_output_file(
+        *this, output.file, *origin_decoder, decoder_name);
+}
 
-    if (linked_decoders.empty())
-        return save(*this, output_file);
+EncodeOutputFileTask::EncodeOutputFileTask(
+    const BaseParallelUnpackingTask &previous_stage,
+    const std::shared_ptr<io::File> input_file,
+    const OutputFileEncoder encoder,
+    const std::shared_ptr<const dec::IDecoder> origin_decoder,
+    const std::string &decoder_name,
+    const size_t resource_size) :
+        BaseParallelUnpackingTask(previous_stage),
+        input_file(input_file),
+        encoder(encoder),
+        origin_decoder(origin_decoder),
+        decoder_name(decoder_name),
+        resource_size(resource_size)
+{
+}
 
-    if (get_depth() >= max_depth)
+bool EncodeOutputFileTask::work() const
+{
+    TraceScope trace_scope(
+        *this, UnpackingStage::Encode, decoder_name, base_name);
+    std::shared_ptr<io::File> output_file;
+    const StatsMeasurement measurement(task_context.unpacker_context.stats);
+    try
     {
-        logger.warn("cycle detected.\n");
-        return save(*this, output_file);
+        output_file = encoder(logger);
     }
+    catch (const std::exception &e)
+    {
+        logger.err("error encoding (%s)\n", e.what());
+        if (source_type == TaskSourceType::NestedDecoding)
+            save(*this, input_file, decoder_name);
+        return false;
+    }
+    task_context.add_stats(
+        decoder_name,
+        StatsStage::Encode,
+        measurement,
+        resource_size,
+        output_file->stream.size());
+    return process_output_file(
+        *this, output_file, *origin_decoder, decoder_name);
+}
 
-    task_context.task_scheduler.push_front(
-        std::make_shared<DecodeInputFileTask>(
-            task_context,
-            TaskSourceType::NestedDecoding,
-            output_file->path,
-            shared_from_this(),
-            linked_decoders,
-            [=]() { return output_file; }));
+SaveFileTask::SaveFileTask(
+    const BaseParallelUnpackingTask &previous_stage,
+    const std::shared_ptr<io::File> file,
+    const std::string &decoder_name) :
+        BaseParallelUnpackingTask(previous_stage),
+        file(file),
+        decoder_name(decoder_name)
+{
+}
 
-    return true;
+bool SaveFileTask::work() const
+{
+    TraceScope trace_scope(
+        *this, UnpackingStage::Write, decoder_name, file->path);
+    // streamed files get decoded while being saved, so this can fail with
+    // data errors as well as I/O errors
+    try
+    {
+        const StatsMeasurement measurement(task_context.unpacker_context.stats);
+        const auto full_path
+            = task_context.unpacker_context.file_saver.save(file);
+        task_context.add_stats(
+            decoder_name,
+            is_streamed(*file) ? StatsStage::StreamedSave : StatsStage::Save,
+            measurement,
+            0,
+            file->stream.size());
+        logger.success("saved to %s\n", full_path.c_str());
+        logger.flush();
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        logger.err(
+            "error saving (%s)\n", e.what() ? e.what() : "unknown error");
+        logger.flush();
+        return false;
+    }
+}
+
+// Decoding and encoding are CPU-bound and may use all the workers, while
+// reading archives and writing files are mostly I/O-bound and get fewer of
+// them, so that they overlap with the former instead of competing with
+// them. The queues are short to limit how many decoded files sit in memory.
+static std::vector<PipelineStage> get_stages(const size_t thread_count)
+{
+    const auto io_thread_count = std::max<size_t>(1, thread_count / 2);
+    const auto queue_capacity = thread_count * 2;
+    return {
+        {"read", io_thread_count, queue_capacity},
+        {"decode", thread_count, queue_capacity},
+        {"encode", thread_count, queue_capacity},
+        {"write", io_thread_count, queue_capacity},
+    };
 }
 
 struct ParallelUnpacker::Priv final
@@ -410,7 +754,9 @@ struct ParallelUnpacker::Priv final
         const ParallelUnpackerContext &unpacker_context);
 
     const ParallelUnpackerContext &unpacker_context;
-    TaskScheduler task_scheduler;
+    Pipeline pipeline;
+    dec::DecoderPool decoder_pool;
+    MemoryBudget memory_budget;
     ParallelTaskContext task_context;
 };
 
@@ -418,8 +764,19 @@ ParallelUnpacker::Priv::Priv(
     ParallelUnpacker &unpacker,
     const ParallelUnpackerContext &unpacker_context) :
         unpacker_context(unpacker_context),
-        task_context(unpacker, unpacker_context, task_scheduler)
+        pipeline(stage_count),
+        decoder_pool(unpacker_context.registry, unpacker_context.arguments),
+        memory_budget(unpacker_context.max_memory),
+        task_context(
+            unpacker,
+            unpacker_context,
+            pipeline,
+            decoder_pool,
+            memory_budget)
 {
+    // archives stop expanding into new entries until the files that are
+    // already decoded get saved
+    pipeline.set_throttle([this]() { return memory_budget.is_exceeded(); });
 }
 
 ParallelUnpacker::ParallelUnpacker(
@@ -435,7 +792,8 @@ ParallelUnpacker::~ParallelUnpacker()
 void ParallelUnpacker::add_input_file(
     const io::path &base_name, const InputFileFactory file_factory)
 {
-    p->task_scheduler.push_back(
+    p->pipeline.push_back(
+        static_cast<size_t>(UnpackingStage::Read),
         std::make_shared<DecodeInputFileTask>(
             p->task_context,
             TaskSourceType::InitialUserInput,
@@ -445,10 +803,16 @@ void ParallelUnpacker::add_input_file(
             file_factory));
 }
 
-bool ParallelUnpacker::run(const size_t thread_count)
+bool ParallelUnpacker::run(size_t thread_count)
 {
+    if (!thread_count)
+        thread_count = std::thread::hardware_concurrency();
+    if (!thread_count)
+        thread_count = 1;
+
     const auto begin = std::chrono::steady_clock::now();
-    const auto results = p->task_scheduler.run(thread_count);
+    const auto results
+        = p->pipeline.run(get_stages(thread_count), thread_count);
     const auto end = std::chrono::steady_clock::now();
     const auto diff
         = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
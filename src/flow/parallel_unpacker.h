@@ -4,9 +4,14 @@
 #include <memory>
 #include <set>
 #include "dec/base_decoder.h"
+#include "dec/decoder_pool.h"
 #include "dec/registry.h"
+#include "enc/base_image_encoder.h"
 #include "flow/ifile_saver.h"
-#include "flow/task_scheduler.h"
+#include "flow/memory_budget.h"
+#include "flow/pipeline.h"
+#include "flow/trace_recorder.h"
+#include "flow/unpacking_stats.h"
 #include "logger.h"
 
 namespace au {
@@ -18,11 +23,35 @@ namespace flow {
         NestedDecoding,
     };
 
+    // every file goes through these in order; nested files start over
+    // from the first one
+    enum class UnpackingStage : u8
+    {
+        Read = 0,
+        Decode = 1,
+        Encode = 2,
+        Write = 3,
+    };
+
     class ParallelUnpacker;
 
+    using OutputFileEncoder
+        = std::function<std::shared_ptr<io::File>(const Logger &)>;
+
+    // Decoders that produce resources rather than files, such as images,
+    // return an encoder instead, so that encoding can run in its own stage.
+    struct DecodedOutputFile final
+    {
+        std::shared_ptr<io::File> file;
+        OutputFileEncoder encoder;
+
+        // size of the decoded resource, for statistics
+        size_t resource_size = 0;
+    };
+
     using InputFileFactory = std::function<std::shared_ptr<io::File>()>;
     using DecoderFileFactory
-        = std::function<std::shared_ptr<io::File>(io::File &, const Logger &)>;
+        = std::function<DecodedOutputFile(io::File &, const Logger &)>;
 
     struct ParallelUnpackerContext final
     {
@@ -32,7 +61,11 @@ namespace flow {
             const dec::Registry &registry,
             const bool enable_nested_decoding,
             const std::vector<std::string> &arguments,
-            const std::set<std::string> &decoders_to_check);
+            const std::set<std::string> &decoders_to_check,
+            const enc::BaseImageEncoder &image_encoder,
+            const size_t max_memory = 0,
+            UnpackingStats *stats = nullptr,
+            TraceRecorder *trace = nullptr);
 
         const Logger &logger;
         const IFileSaver &file_saver;
@@ -40,6 +73,10 @@ namespace flow {
         const bool enable_nested_decoding;
         const std::vector<std::string> arguments;
         const std::set<std::string> decoders_to_check;
+        const enc::BaseImageEncoder &image_encoder;
+        const size_t max_memory;
+        UnpackingStats *stats;
+        TraceRecorder *trace;
     };
 
     struct ParallelTaskContext final
@@ -47,11 +84,26 @@ namespace flow {
         ParallelTaskContext(
             ParallelUnpacker &unpacker,
             const ParallelUnpackerContext &unpacker_context,
-            TaskScheduler &task_scheduler);
+            Pipeline &pipeline,
+            dec::DecoderPool &decoder_pool,
+            MemoryBudget &memory_budget);
+
+        void push(
+            const UnpackingStage stage, std::shared_ptr<ITask> task) const;
+
+        // does nothing unless the unpacker collects statistics
+        void add_stats(
+            const std::string &decoder_name,
+            const StatsStage stage,
+            const StatsMeasurement &measurement,
+            const size_t bytes_in,
+            const size_t bytes_out) const;
 
         ParallelUnpacker &unpacker;
         const ParallelUnpackerContext &unpacker_context;
-        TaskScheduler &task_scheduler;
+        Pipeline &pipeline;
+        dec::DecoderPool &decoder_pool;
+        MemoryBudget &memory_budget;
     };
 
     struct BaseParallelUnpackingTask :
@@ -73,6 +125,7 @@ namespace flow {
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory,
             const dec::BaseDecoder &origin_decoder,
+            const std::string &decoder_name,
             const std::string &custom_name = "") const;
 
         Logger logger;
@@ -81,6 +134,9 @@ namespace flow {
         const io::path base_name;
         const std::shared_ptr<const BaseParallelUnpackingTask> parent_task;
         const std::set<std::string> decoders_to_check;
+
+        // tasks that continue the work of another task keep its id
+        const int task_id;
     };
 
     class ParallelUnpacker final
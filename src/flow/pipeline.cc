@@ -0,0 +1,419 @@
+#include "flow/pipeline.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "algo/parallel.h"
+#include "algo/range.h"
+#include "types.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    struct QueuedTask final
+    {
+        s64 priority;
+        std::shared_ptr<ITask> task;
+    };
+
+    // A deque of tasks for each stage. The owner pushes and pops at the
+    // front, the other workers steal the oldest tasks from the back.
+    class TaskQueue final
+    {
+    public:
+        TaskQueue(const size_t stage_count);
+
+        void push(const size_t stage, QueuedTask task, const bool front);
+        std::shared_ptr<ITask> pop_back(const size_t stage);
+
+        // pops the most recently pushed task of the stages the callback
+        // accepts; the callback may reject a stage only once per call
+        template<typename T> std::shared_ptr<ITask> pop_front(
+            const size_t first_stage, size_t &stage, T try_accept);
+
+    private:
+        std::mutex mutex;
+        std::vector<std::deque<QueuedTask>> tasks;
+    };
+
+    struct StageState final
+    {
+        PipelineStage settings;
+
+        // number of tasks sitting in all the queues
+        std::atomic<size_t> queued_count;
+
+        std::atomic<size_t> running_count;
+    };
+
+    struct WorkerIdentity final
+    {
+        const void *pipeline;
+        size_t index;
+        size_t stage;
+    };
+}
+
+static thread_local WorkerIdentity current_worker = {nullptr, 0, 0};
+
+TaskQueue::TaskQueue(const size_t stage_count) : tasks(stage_count)
+{
+}
+
+void TaskQueue::push(const size_t stage, QueuedTask task, const bool front)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (front)
+        tasks[stage].push_front(std::move(task));
+    else
+        tasks[stage].push_back(std::move(task));
+}
+
+std::shared_ptr<ITask> TaskQueue::pop_back(const size_t stage)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (tasks[stage].empty())
+        return nullptr;
+    auto task = std::move(tasks[stage].back().task);
+    tasks[stage].pop_back();
+    return task;
+}
+
+template<typename T> std::shared_ptr<ITask> TaskQueue::pop_front(
+    const size_t first_stage, size_t &stage, T try_accept)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    std::vector<bool> rejected(tasks.size());
+    while (true)
+    {
+        bool found = false;
+        for (const auto i : algo::range(first_stage, tasks.size()))
+        {
+            if (rejected[i] || tasks[i].empty())
+                continue;
+            if (!found
+                || tasks[i].front().priority > tasks[stage].front().priority)
+            {
+                stage = i;
+                found = true;
+            }
+        }
+        if (!found)
+            return nullptr;
+        if (!try_accept(stage))
+        {
+            rejected[stage] = true;
+            continue;
+        }
+        auto task = std::move(tasks[stage].front().task);
+        tasks[stage].pop_front();
+        return task;
+    }
+}
+
+struct Pipeline::Priv final
+{
+    Priv(const size_t stage_count);
+
+    bool is_throttled() const;
+    bool are_later_stages_busy() const;
+
+    // reserves a running slot in the stage
+    bool try_start(
+        const size_t stage,
+        const bool respect_limits,
+        const bool hold_first_stage);
+
+    std::shared_ptr<ITask> find_next_task(
+        const size_t first_stage, const bool respect_limits, size_t &stage);
+
+    bool execute_next_task(const size_t first_stage, const bool respect_limits);
+    void notify(const bool finished);
+
+    void push(const size_t stage, std::shared_ptr<ITask> task, bool front);
+    void work(const size_t worker_index);
+
+    std::vector<StageState> stages;
+
+    // receives the tasks pushed from outside of the workers
+    TaskQueue shared_queue;
+    std::vector<std::unique_ptr<TaskQueue>> worker_queues;
+
+    std::function<bool()> throttle;
+
+    // tasks pushed to the front get increasing priorities, tasks pushed to
+    // the back get decreasing negative ones
+    std::atomic<s64> last_priority;
+
+    // number of tasks that were pushed and didn't finish yet
+    std::atomic<size_t> pending_count;
+
+    // changes whenever a task is pushed or finishes, so that workers that
+    // found nothing to do can tell if it's worth looking again
+    std::atomic<size_t> generation;
+
+    std::atomic<size_t> sleeping_count;
+    std::mutex idle_mutex;
+    std::condition_variable idle_condition;
+
+    std::atomic<int> success_count;
+    std::atomic<int> error_count;
+};
+
+Pipeline::Priv::Priv(const size_t stage_count) :
+    stages(stage_count),
+    shared_queue(stage_count),
+    last_priority(0),
+    pending_count(0),
+    generation(0),
+    sleeping_count(0),
+    success_count(0),
+    error_count(0)
+{
+    for (auto &stage : stages)
+    {
+        stage.queued_count = 0;
+        stage.running_count = 0;
+    }
+}
+
+bool Pipeline::Priv::is_throttled() const
+{
+    return throttle && throttle();
+}
+
+bool Pipeline::Priv::are_later_stages_busy() const
+{
+    for (const auto i : algo::range(1, stages.size()))
+        if (stages[i].queued_count || stages[i].running_count)
+            return true;
+    return false;
+}
+
+bool Pipeline::Priv::try_start(
+    const size_t stage, const bool respect_limits, const bool hold_first_stage)
+{
+    auto &state = stages[stage];
+    if (!respect_limits)
+    {
+        ++state.running_count;
+        return true;
+    }
+    if (stage == 0 && hold_first_stage)
+        return false;
+    auto running_count = state.running_count.load();
+    while (running_count < state.settings.thread_count)
+    {
+        if (state.running_count.compare_exchange_weak(
+                running_count, running_count + 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<ITask> Pipeline::Priv::find_next_task(
+    const size_t first_stage, const bool respect_limits, size_t &stage)
+{
+    const auto hold_first_stage = respect_limits
+        && first_stage == 0
+        && is_throttled()
+        && are_later_stages_busy();
+    const auto try_accept = [&](const size_t stage)
+    {
+        return try_start(stage, respect_limits, hold_first_stage);
+    };
+
+    // own tasks and the ones pushed from outside, newest first
+    std::shared_ptr<ITask> task;
+    if (current_worker.pipeline == this)
+    {
+        auto &own_queue = *worker_queues[current_worker.index];
+        task = own_queue.pop_front(first_stage, stage, try_accept);
+    }
+    if (!task)
+        task = shared_queue.pop_front(first_stage, stage, try_accept);
+
+    // steal the oldest tasks of the other workers, starting with the ones
+    // closest to completion
+    for (auto i = stages.size(); i-- > first_stage && !task; )
+    {
+        if (!stages[i].queued_count || !try_accept(i))
+            continue;
+        for (const auto &queue : worker_queues)
+            if ((task = queue->pop_back(i)))
+                break;
+        if (task)
+            stage = i;
+        else
+            --stages[i].running_count;
+    }
+
+    if (task)
+        --stages[stage].queued_count;
+    return task;
+}
+
+bool Pipeline::Priv::execute_next_task(
+    const size_t first_stage, const bool respect_limits)
+{
+    size_t stage;
+    const auto task = find_next_task(first_stage, respect_limits, stage);
+    if (!task)
+        return false;
+
+    const auto previous_stage = current_worker.stage;
+    current_worker.stage = stage;
+    bool result;
+    try
+    {
+        // idle workers leave their share of the cores to parallel_for
+        algo::BusyThreadScope busy;
+        result = task->work();
+    }
+    catch (...)
+    {
+        // an exception escaping a worker would terminate the process
+        result = false;
+    }
+    current_worker.stage = previous_stage;
+
+    --stages[stage].running_count;
+    if (result)
+        ++success_count;
+    else
+        ++error_count;
+    notify(--pending_count == 0);
+    return true;
+}
+
+void Pipeline::Priv::notify(const bool finished)
+{
+    ++generation;
+    if (!sleeping_count && !finished)
+        return;
+    {
+        // synchronize with workers that are about to fall asleep
+        std::unique_lock<std::mutex> lock(idle_mutex);
+    }
+    if (finished)
+        idle_condition.notify_all();
+    else
+        idle_condition.notify_one();
+}
+
+void Pipeline::Priv::push(
+    const size_t stage, std::shared_ptr<ITask> task, bool front)
+{
+    if (stage >= stages.size())
+        throw std::logic_error("Bad pipeline stage");
+    ++pending_count;
+
+    // rather than waiting for the later stages to make room, help them;
+    // should the queued tasks be already taken, push regardless
+    const auto is_own_worker = current_worker.pipeline == this;
+    if (is_own_worker && stage > current_worker.stage)
+    {
+        auto &state = stages[stage];
+        while (state.queued_count >= state.settings.queue_capacity
+            || (state.queued_count && is_throttled()))
+        {
+            if (!execute_next_task(stage, false))
+                break;
+        }
+    }
+
+    const auto priority = front ? ++last_priority : -++last_priority;
+    auto &queue = is_own_worker
+        ? *worker_queues[current_worker.index]
+        : shared_queue;
+    queue.push(stage, {priority, std::move(task)}, front);
+    ++stages[stage].queued_count;
+    notify(false);
+}
+
+void Pipeline::Priv::work(const size_t worker_index)
+{
+    const auto previous_worker = current_worker;
+    current_worker.pipeline = this;
+    current_worker.index = worker_index;
+    current_worker.stage = 0;
+
+    while (pending_count)
+    {
+        const size_t last_generation = generation;
+        if (execute_next_task(0, true))
+            continue;
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        ++sleeping_count;
+        idle_condition.wait(lock, [&]()
+        {
+            return !pending_count || generation != last_generation;
+        });
+        --sleeping_count;
+    }
+
+    current_worker = previous_worker;
+}
+
+Pipeline::Pipeline(const size_t stage_count) : p(new Priv(stage_count))
+{
+}
+
+Pipeline::~Pipeline()
+{
+}
+
+void Pipeline::push_front(const size_t stage, std::shared_ptr<ITask> task)
+{
+    p->push(stage, std::move(task), true);
+}
+
+void Pipeline::push_back(const size_t stage, std::shared_ptr<ITask> task)
+{
+    p->push(stage, std::move(task), false);
+}
+
+void Pipeline::set_throttle(const std::function<bool()> is_throttled)
+{
+    p->throttle = is_throttled;
+}
+
+PipelineResult Pipeline::run(
+    const std::vector<PipelineStage> &stages, size_t number_of_threads)
+{
+    if (stages.size() != p->stages.size())
+        throw std::logic_error("Bad pipeline stage count");
+    if (!number_of_threads)
+        number_of_threads = std::thread::hardware_concurrency();
+    if (!number_of_threads)
+        number_of_threads = 1;
+
+    for (const auto i : algo::range(stages.size()))
+    {
+        auto &settings = p->stages[i].settings;
+        settings = stages[i];
+        settings.thread_count = std::max<size_t>(1, settings.thread_count);
+        settings.queue_capacity = std::max<size_t>(1, settings.queue_capacity);
+    }
+    p->success_count = 0;
+    p->error_count = 0;
+    p->worker_queues.clear();
+    for (const auto i : algo::range(number_of_threads))
+        p->worker_queues.push_back(std::make_unique<TaskQueue>(stages.size()));
+
+    std::vector<std::thread> threads;
+    for (const auto i : algo::range(number_of_threads))
+        threads.emplace_back([this, i]() { p->work(i); });
+    for (auto &thread : threads)
+        thread.join();
+
+    PipelineResult result;
+    result.success_count = p->success_count;
+    result.error_count = p->error_count;
+    return result;
+}
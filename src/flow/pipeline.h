@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace au {
+namespace flow {
+
+    class ITask
+    {
+    public:
+        virtual ~ITask() {}
+        virtual bool work() const = 0;
+    };
+
+    struct PipelineResult final
+    {
+        int success_count;
+        int error_count;
+    };
+
+    struct PipelineStage final
+    {
+        std::string name;
+
+        // how many workers can run tasks of this stage at the same time
+        size_t thread_count;
+
+        // how many tasks can wait in this stage before the earlier stages
+        // have to stop producing them
+        size_t queue_capacity;
+    };
+
+    // Runs tasks that are split into consecutive stages on a shared pool of
+    // workers. Each stage has its own queue, so that a slow stage cannot be
+    // flooded by the stages before it: when a task pushes to a later stage
+    // whose queue is full, its worker executes the tasks of that stage (or
+    // the stages after it) until there is room again. Pushes to the same
+    // or an earlier stage never wait, which keeps the pipeline free of
+    // deadlocks.
+    //
+    // Each worker owns a deque per stage. Tasks pushed from within a
+    // running task go to the current worker's own deques, tasks pushed from
+    // outside go to shared ones. Workers pick the most recently pushed task
+    // of their own they are allowed to run, so the work that is closest to
+    // completion finishes first; idle workers steal the oldest tasks of the
+    // others and sleep until new tasks arrive. Since the queue sizes are
+    // only checked before pushing, a queue may briefly hold a few tasks more
+    // than its capacity. run() returns once all the queues are empty and no
+    // task is being executed.
+    class Pipeline final
+    {
+    public:
+        Pipeline(const size_t stage_count);
+        ~Pipeline();
+
+        // expects settings for each of the stages
+        PipelineResult run(
+            const std::vector<PipelineStage> &stages,
+            const size_t number_of_threads = 0);
+
+        // executed before any task that is already queued
+        void push_front(const size_t stage, std::shared_ptr<ITask> task);
+
+        // executed after all the tasks that are already queued
+        void push_back(const size_t stage, std::shared_ptr<ITask> task);
+
+        // While the callback returns true, tasks of the first stage, which
+        // is the one that creates new work, don't start until the later
+        // stages are done, and tasks pushing to the later stages execute
+        // the already queued ones first.
+        void set_throttle(const std::function<bool()> is_throttled);
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
@@ -0,0 +1,130 @@
+#include "flow/trace_recorder.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "algo/format.h"
+#include "algo/range.h"
+#include "algo/str.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    struct Event final
+    {
+        char phase;
+        std::string name;
+        size_t thread_number;
+        double timestamp; // in microseconds
+        TraceArguments arguments;
+    };
+}
+
+static std::string format_arguments(const TraceArguments &arguments)
+{
+    std::string output;
+    for (const auto &kv : arguments)
+    {
+        if (!output.empty())
+            output += ", ";
+        output += algo::format(
+            "\"%s\": \"%s\"",
+            algo::escape_json(kv.first).c_str(),
+            algo::escape_json(kv.second).c_str());
+    }
+    return "{" + output + "}";
+}
+
+struct TraceRecorder::Priv final
+{
+    Priv();
+
+    void add(
+        const char phase,
+        const std::string &name,
+        const TraceArguments &arguments);
+
+    const std::chrono::steady_clock::time_point start;
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+
+    // thread ids are hard to read, so threads are numbered in the order
+    // they first record something
+    std::map<std::thread::id, size_t> thread_numbers;
+};
+
+TraceRecorder::Priv::Priv() : start(std::chrono::steady_clock::now())
+{
+}
+
+void TraceRecorder::Priv::add(
+    const char phase,
+    const std::string &name,
+    const TraceArguments &arguments)
+{
+    const auto timestamp = std::chrono::duration_cast<
+        std::chrono::duration<double, std::micro>>(
+            std::chrono::steady_clock::now() - start).count();
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto thread_id = std::this_thread::get_id();
+    auto it = thread_numbers.find(thread_id);
+    if (it == thread_numbers.end())
+    {
+        it = thread_numbers.insert(
+            {thread_id, thread_numbers.size() + 1}).first;
+    }
+    events.push_back({phase, name, it->second, timestamp, arguments});
+}
+
+TraceRecorder::TraceRecorder() : p(new Priv())
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+}
+
+void TraceRecorder::begin(
+    const std::string &name, const TraceArguments &arguments)
+{
+    p->add('B', name, arguments);
+}
+
+void TraceRecorder::end(
+    const std::string &name, const TraceArguments &arguments)
+{
+    p->add('E', name, arguments);
+}
+
+std::string TraceRecorder::format_json() const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    std::vector<std::string> lines;
+    for (const auto number : algo::range(1, p->thread_numbers.size() + 1))
+    {
+        lines.push_back(algo::format(
+            "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, "
+            "\"tid\": %d, \"args\": {\"name\": \"thread %d\"}}",
+            static_cast<int>(number),
+            static_cast<int>(number)));
+    }
+    for (const auto &event : p->events)
+    {
+        lines.push_back(algo::format(
+            "{\"ph\": \"%c\", \"name\": \"%s\", \"pid\": 1, \"tid\": %d, "
+            "\"ts\": %.03f, \"args\": %s}",
+            event.phase,
+            algo::escape_json(event.name).c_str(),
+            static_cast<int>(event.thread_number),
+            event.timestamp,
+            format_arguments(event.arguments).c_str()));
+    }
+
+    std::string output = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (const auto &line : lines)
+        output += (&line == &lines.front() ? "\n  " : ",\n  ") + line;
+    output += "\n]}\n";
+    return output;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace au {
+namespace flow {
+
+    using TraceArguments = std::map<std::string, std::string>;
+
+    // Records what each thread was doing and when, in the Chrome trace
+    // event format that chrome://tracing and Perfetto can display. Events
+    // of a single thread must be properly nested.
+    class TraceRecorder final
+    {
+    public:
+        TraceRecorder();
+        ~TraceRecorder();
+
+        void begin(const std::string &name, const TraceArguments &arguments);
+
+        // arguments of both events end up merged together
+        void end(const std::string &name, const TraceArguments &arguments);
+
+        std::string format_json() const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
@@ -0,0 +1,229 @@
+#include "flow/unpacking_stats.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "algo/format.h"
+#include "algo/str.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    struct Record final
+    {
+        std::vector<double> durations; // in seconds
+        size_t bytes_in;
+        size_t bytes_out;
+        size_t allocation_count;
+        size_t allocated_bytes;
+        size_t peak_live_bytes;
+    };
+
+    struct Summary final
+    {
+        std::string decoder_name;
+        std::string stage_name;
+        size_t count;
+        double total;
+        double p50, p90, p99, max;
+        size_t bytes_in;
+        size_t bytes_out;
+        size_t allocation_count;
+        size_t allocated_bytes;
+        size_t peak_live_bytes;
+    };
+}
+
+static const char *stage_names[] =
+{
+    "recognition",
+    "read_meta",
+    "read_file",
+    "decode",
+    "encode",
+    "save",
+    "read_file+save",
+};
+
+static double get_percentile(
+    const std::vector<double> &sorted_values, const double percentile)
+{
+    const auto index = static_cast<size_t>(
+        percentile * (sorted_values.size() - 1) + 0.5);
+    return sorted_values[index];
+}
+
+static std::string format_bytes(const size_t bytes)
+{
+    if (bytes < 1024)
+        return algo::format("%d B", static_cast<int>(bytes));
+    if (bytes < 1024 * 1024)
+        return algo::format("%.01f KiB", bytes / 1024.0);
+    if (bytes < 1024 * 1024 * 1024)
+        return algo::format("%.01f MiB", bytes / 1024.0 / 1024.0);
+    return algo::format("%.01f GiB", bytes / 1024.0 / 1024.0 / 1024.0);
+}
+
+struct UnpackingStats::Priv final
+{
+    std::vector<Summary> summarize() const;
+
+    mutable std::mutex mutex;
+    std::map<std::tuple<std::string, StatsStage>, Record> records;
+};
+
+std::vector<Summary> UnpackingStats::Priv::summarize() const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    std::vector<Summary> summaries;
+    for (const auto &kv : records)
+    {
+        auto durations = kv.second.durations;
+        std::sort(durations.begin(), durations.end());
+        Summary summary;
+        summary.decoder_name = std::get<0>(kv.first);
+        summary.stage_name
+            = stage_names[static_cast<size_t>(std::get<1>(kv.first))];
+        summary.count = durations.size();
+        summary.total = 0;
+        for (const auto duration : durations)
+            summary.total += duration;
+        summary.p50 = get_percentile(durations, 0.5);
+        summary.p90 = get_percentile(durations, 0.9);
+        summary.p99 = get_percentile(durations, 0.99);
+        summary.max = durations.back();
+        summary.bytes_in = kv.second.bytes_in;
+        summary.bytes_out = kv.second.bytes_out;
+        summary.allocation_count = kv.second.allocation_count;
+        summary.allocated_bytes = kv.second.allocated_bytes;
+        summary.peak_live_bytes = kv.second.peak_live_bytes;
+        summaries.push_back(summary);
+    }
+
+    // the most expensive steps go first
+    std::stable_sort(
+        summaries.begin(),
+        summaries.end(),
+        [](const Summary &a, const Summary &b) { return a.total > b.total; });
+    return summaries;
+}
+
+StatsMeasurement::StatsMeasurement(const UnpackingStats *stats) :
+    start(std::chrono::steady_clock::now()),
+    allocation_scope(stats != nullptr)
+{
+}
+
+StatsSample StatsMeasurement::finish(
+    const size_t bytes_in, const size_t bytes_out) const
+{
+    StatsSample sample;
+    sample.duration = std::chrono::steady_clock::now() - start;
+    sample.allocations = allocation_scope.get_counters();
+    sample.bytes_in = bytes_in;
+    sample.bytes_out = bytes_out;
+    return sample;
+}
+
+UnpackingStats::UnpackingStats() : p(new Priv())
+{
+}
+
+UnpackingStats::~UnpackingStats()
+{
+}
+
+void UnpackingStats::add(
+    const std::string &decoder_name,
+    const StatsStage stage,
+    const StatsSample &sample)
+{
+    const auto seconds = std::chrono::duration_cast<
+        std::chrono::duration<double>>(sample.duration).count();
+    std::unique_lock<std::mutex> lock(p->mutex);
+    auto &record = p->records[std::make_tuple(decoder_name, stage)];
+    record.durations.push_back(seconds);
+    record.bytes_in += sample.bytes_in;
+    record.bytes_out += sample.bytes_out;
+    record.allocation_count += sample.allocations.allocation_count;
+    record.allocated_bytes += sample.allocations.allocated_bytes;
+    record.peak_live_bytes = std::max(
+        record.peak_live_bytes, sample.allocations.peak_live_bytes);
+}
+
+std::string UnpackingStats::format_table() const
+{
+    std::string output = algo::format(
+        "%-30s %-11s %7s %10s %9s %9s %9s %9s %11s %11s %9s %11s %11s\n",
+        "Decoder",
+        "Stage",
+        "Count",
+        "Total ms",
+        "p50 ms",
+        "p90 ms",
+        "p99 ms",
+        "Max ms",
+        "Bytes in",
+        "Bytes out",
+        "Allocs",
+        "Alloc bytes",
+        "Peak live");
+    for (const auto &summary : p->summarize())
+    {
+        output += algo::format(
+            "%-30s %-11s %7d %10.03f %9.03f %9.03f %9.03f %9.03f "
+            "%11s %11s %9d %11s %11s\n",
+            summary.decoder_name.c_str(),
+            summary.stage_name.c_str(),
+            static_cast<int>(summary.count),
+            summary.total * 1000,
+            summary.p50 * 1000,
+            summary.p90 * 1000,
+            summary.p99 * 1000,
+            summary.max * 1000,
+            format_bytes(summary.bytes_in).c_str(),
+            format_bytes(summary.bytes_out).c_str(),
+            static_cast<int>(summary.allocation_count),
+            format_bytes(summary.allocated_bytes).c_str(),
+            format_bytes(summary.peak_live_bytes).c_str());
+    }
+    return output;
+}
+
+std::string UnpackingStats::format_json() const
+{
+    const auto summaries = p->summarize();
+    if (summaries.empty())
+        return "[]\n";
+    std::string output = "[\n";
+    for (const auto &summary : summaries)
+    {
+        if (&summary != &summaries.front())
+            output += ",\n";
+        output += algo::format(
+            "  {\"decoder\": \"%s\", \"stage\": \"%s\", \"count\": %d, "
+            "\"total_ms\": %.03f, \"p50_ms\": %.03f, \"p90_ms\": %.03f, "
+            "\"p99_ms\": %.03f, \"max_ms\": %.03f, "
+            "\"bytes_in\": %llu, \"bytes_out\": %llu, "
+            "\"allocations\": %llu, \"allocated_bytes\": %llu, "
+            "\"peak_live_bytes\": %llu}",
+            algo::escape_json(summary.decoder_name).c_str(),
+            summary.stage_name.c_str(),
+            static_cast<int>(summary.count),
+            summary.total * 1000,
+            summary.p50 * 1000,
+            summary.p90 * 1000,
+            summary.p99 * 1000,
+            summary.max * 1000,
+            static_cast<unsigned long long>(summary.bytes_in),
+            static_cast<unsigned long long>(summary.bytes_out),
+            static_cast<unsigned long long>(summary.allocation_count),
+            static_cast<unsigned long long>(summary.allocated_bytes),
+            static_cast<unsigned long long>(summary.peak_live_bytes));
+    }
+    output += "\n]\n";
+    return output;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include "flow/allocation_tracker.h"
+#include "types.h"
+
+namespace au {
+namespace flow {
+
+    enum class StatsStage : u8
+    {
+        Recognition = 0,
+        ReadMeta = 1,
+        ReadFile = 2,
+        Decode = 3,
+        Encode = 4,
+        Save = 5,
+
+        // saving an archive entry that is read from the archive as it's
+        // being written, so the time covers both
+        StreamedSave = 6,
+    };
+
+    struct StatsSample final
+    {
+        std::chrono::steady_clock::duration duration;
+        AllocationCounters allocations;
+        size_t bytes_in;
+        size_t bytes_out;
+    };
+
+    class UnpackingStats;
+
+    // Measures the time spent and the memory allocated by the current
+    // thread from its creation on. Does nothing without statistics to add
+    // to, since counting allocations slows them down.
+    class StatsMeasurement final
+    {
+    public:
+        StatsMeasurement(const UnpackingStats *stats);
+
+        StatsSample finish(const size_t bytes_in, const size_t bytes_out) const;
+
+    private:
+        const std::chrono::steady_clock::time_point start;
+        const AllocationScope allocation_scope;
+    };
+
+    // Collects timings, data sizes and allocations of the unpacking steps,
+    // grouped by decoder and stage. Safe to use from many threads at once.
+    class UnpackingStats final
+    {
+    public:
+        UnpackingStats();
+        ~UnpackingStats();
+
+        void add(
+            const std::string &decoder_name,
+            const StatsStage stage,
+            const StatsSample &sample);
+
+        std::string format_table() const;
+        std::string format_json() const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
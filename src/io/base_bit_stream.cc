@@ -7,6 +7,14 @@ using namespace au::io;
 
 BaseBitStream::~BaseBitStream() {}
 
+BaseBitStream::BaseBitStream() :
+    buffer(0),
+    bits_available(0),
+    position(0),
+    input_stream(nullptr)
+{
+}
+
 BaseBitStream::BaseBitStream(const bstr &input) :
     buffer(0),
     bits_available(0),
@@ -25,6 +25,10 @@ namespace io {
         virtual void write(const size_t bits, const u32 value);
 
     protected:
+        // for bit streams that read their input through a BitReader rather
+        // than a byte stream
+        BaseBitStream();
+
         u64 buffer;
         size_t bits_available;
         size_t position;
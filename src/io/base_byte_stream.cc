@@ -34,6 +34,11 @@ bstr BaseByteStream::read_to_eof()
     return read(size() - tell());
 }
 
+bslice BaseByteStream::read_slice(const size_t bytes)
+{
+    return bslice(read(bytes));
+}
+
 bstr BaseByteStream::read_line()
 {
     bstr output;
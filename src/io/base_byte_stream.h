@@ -47,6 +47,10 @@ namespace io {
             return ret;
         }
 
+        // Like read(), but streams backed by immutable memory can return
+        // a view of their data rather than a copy.
+        virtual bslice read_slice(const size_t bytes);
+
         template<typename T> T read()
         {
             static_assert(
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include "algo/endian.h"
+#include "err.h"
+#include "types.h"
+
+namespace au {
+namespace io {
+
+    enum class BitOrder : u8
+    {
+        Msb,
+        Lsb,
+    };
+
+    // Reads bits from a contiguous buffer that must outlive the reader.
+    // The bits are kept in a 64-bit register refilled a word at a time,
+    // so that hot loops can peek at up to 32 bits and consume them without
+    // virtual calls or per-byte bookkeeping.
+    template<BitOrder order> class BitReader final
+    {
+    public:
+        BitReader() : BitReader(nullptr, 0)
+        {
+        }
+
+        BitReader(const u8 *data, const size_t size) :
+            start(data),
+            next(data),
+            end(data + size),
+            buffer(0),
+            bits_available(0)
+        {
+        }
+
+        size_t size() const
+        {
+            return (end - start) << 3;
+        }
+
+        size_t tell() const
+        {
+            return ((next - start) << 3) - bits_available;
+        }
+
+        size_t left() const
+        {
+            return size() - tell();
+        }
+
+        bool eof() const
+        {
+            return next == end && !bits_available;
+        }
+
+        void seek(const size_t pos)
+        {
+            if (pos > size())
+                throw err::EofError();
+            next = start + (pos >> 3);
+            buffer = 0;
+            bits_available = 0;
+            refill();
+            consume(pos & 7);
+        }
+
+        // makes at least 56 bits available, unless the input ends sooner
+        void refill()
+        {
+            if (end - next >= 8)
+            {
+                if (order == BitOrder::Msb)
+                    buffer |= load_word() >> bits_available;
+                else
+                    buffer |= load_word() << bits_available;
+                // the bits of the partially loaded byte are left in the
+                // buffer and get loaded again with the same values
+                next += (63 - bits_available) >> 3;
+                bits_available |= 56;
+                return;
+            }
+            while (bits_available < 56 && next < end)
+            {
+                const u64 byte = *next++;
+                if (order == BitOrder::Msb)
+                    buffer |= byte << (56 - bits_available);
+                else
+                    buffer |= byte << bits_available;
+                bits_available += 8;
+            }
+        }
+
+        size_t available() const
+        {
+            return bits_available;
+        }
+
+        // returns up to 32 next bits without consuming them; only the
+        // available() ones are meaningful, bits past the end read as zeros
+        u32 peek(const size_t bits) const
+        {
+            if (order == BitOrder::Msb)
+                return (buffer >> 1) >> (63 - bits);
+            return buffer & ((1ull << bits) - 1);
+        }
+
+        void consume(const size_t bits)
+        {
+            if (bits > bits_available)
+                throw err::EofError();
+            drop(bits);
+        }
+
+        // reads up to 32 bits; on errors, the position stays unchanged
+        u32 read(const size_t bits)
+        {
+            if (bits > bits_available)
+            {
+                refill();
+                if (bits > bits_available)
+                    throw err::EofError();
+            }
+            const auto value = peek(bits);
+            drop(bits);
+            return value;
+        }
+
+    private:
+        // the next 8 bytes, with the first one in the bits read first
+        u64 load_word() const
+        {
+            u64 word;
+            std::memcpy(&word, next, 8);
+            if (order == BitOrder::Lsb)
+                return algo::from_little_endian(word);
+            if (algo::get_machine_endianness()
+                    == algo::Endianness::BigEndian)
+            {
+                return word;
+            }
+            // algo::from_big_endian doesn't compile to a single instruction
+            #if defined(__GNUC__)
+                return __builtin_bswap64(word);
+            #elif defined(_MSC_VER)
+                return _byteswap_uint64(word);
+            #else
+                return algo::from_big_endian(word);
+            #endif
+        }
+
+        void drop(const size_t bits)
+        {
+            if (order == BitOrder::Msb)
+                buffer <<= bits;
+            else
+                buffer >>= bits;
+            bits_available -= bits;
+        }
+
+        const u8 *start;
+        const u8 *next;
+        const u8 *end;
+        u64 buffer;
+        size_t bits_available;
+    };
+
+} }
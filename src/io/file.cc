@@ -1,6 +1,8 @@
 #include "io/file.h"
 #include <string>
+#include "err.h"
 #include "io/file_stream.h"
+#include "io/mapped_file_stream.h"
 #include "io/memory_stream.h"
 
 using namespace au;
@@ -17,6 +19,23 @@ static const std::vector<std::pair<bstr, std::string>> magic_definitions
     {"\xFF\xD8\xFF"_b, "jpeg"},
 };
 
+static std::unique_ptr<io::BaseByteStream> open_file_stream(
+    const io::path &path, const io::FileMode mode)
+{
+    if (mode == io::FileMode::Read)
+    {
+        try
+        {
+            return std::make_unique<io::MappedFileStream>(path);
+        }
+        catch (const err::IoError &)
+        {
+            // fall back to regular I/O, e.g. when running out of address space
+        }
+    }
+    return std::make_unique<io::FileStream>(path, mode);
+}
+
 File::File(File &other_file) :
     stream_holder(other_file.stream.clone()),
     stream(*stream_holder),
@@ -25,7 +44,7 @@ File::File(File &other_file) :
 }
 
 File::File(const io::path &path, const io::FileMode mode) :
-    stream_holder(new io::FileStream(path, mode)),
+    stream_holder(open_file_stream(path, mode)),
     stream(*stream_holder),
     path(path)
 {
@@ -38,6 +57,13 @@ File::File(const io::path &path, const bstr &data) :
 {
 }
 
+File::File(const io::path &path, std::unique_ptr<io::BaseByteStream> stream) :
+    stream_holder(std::move(stream)),
+    stream(*stream_holder),
+    path(path)
+{
+}
+
 File::File() : stream_holder(new io::MemoryStream()), stream(*stream_holder)
 {
 }
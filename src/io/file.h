@@ -12,6 +12,7 @@ namespace io {
         File(File &other_file);
         File(const io::path &path, const io::FileMode mode);
         File(const io::path &path, const bstr &data);
+        File(const io::path &path, std::unique_ptr<io::BaseByteStream> stream);
         File();
         ~File();
 
@@ -29,6 +29,17 @@ path io::absolute(const path &p)
     return boost::filesystem::absolute(p.str()).string();
 }
 
+path io::temporary_directory()
+{
+    return boost::filesystem::temp_directory_path().string();
+}
+
+// %-signs in the model are replaced with random hexadecimal digits
+path io::unique_path(const path &model)
+{
+    return boost::filesystem::unique_path(model.str()).string();
+}
+
 void io::create_directories(const path &p)
 {
     const auto bp = boost::filesystem::path(p.str());
@@ -40,3 +51,18 @@ void io::remove(const path &p)
 {
     boost::filesystem::remove(p.str());
 }
+
+void io::remove_all(const path &p)
+{
+    boost::filesystem::remove_all(p.str());
+}
+
+void io::remove(const path &p, boost::system::error_code &ec)
+{
+    boost::filesystem::remove(p.str(), ec);
+}
+
+void io::remove_all(const path &p, boost::system::error_code &ec)
+{
+    boost::filesystem::remove_all(p.str(), ec);
+}
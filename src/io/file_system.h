@@ -12,8 +12,16 @@ namespace io {
     bool is_regular_file(const path &p);
     path absolute(const path &p);
 
+    path temporary_directory();
+    path unique_path(const path &model);
+
     void create_directories(const path &p);
     void remove(const path &p);
+    void remove_all(const path &p);
+
+    // report failures through the error code instead of throwing
+    void remove(const path &p, boost::system::error_code &ec);
+    void remove_all(const path &p, boost::system::error_code &ec);
 
     template<typename T> class BaseDirectoryRange final
     {
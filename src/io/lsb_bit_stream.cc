@@ -3,7 +3,9 @@
 using namespace au;
 using namespace au::io;
 
-LsbBitStream::LsbBitStream(const bstr &input) : BaseBitStream(input)
+LsbBitStream::LsbBitStream(const bstr &input) :
+    data(input),
+    reader(data.get<u8>(), data.size())
 {
 }
 
@@ -12,11 +14,31 @@ LsbBitStream::LsbBitStream(io::BaseByteStream &input_stream)
 {
 }
 
+size_t LsbBitStream::tell() const
+{
+    return input_stream ? BaseBitStream::tell() : reader.tell();
+}
+
+size_t LsbBitStream::size() const
+{
+    return input_stream ? BaseBitStream::size() : reader.size();
+}
+
+BaseStream &LsbBitStream::seek(const size_t offset)
+{
+    if (input_stream)
+        return BaseBitStream::seek(offset);
+    reader.seek(offset);
+    return *this;
+}
+
 u32 LsbBitStream::read(const size_t bits)
 {
+    if (!input_stream)
+        return reader.read(bits);
     while (bits_available < bits)
     {
-        const auto tmp = input_stream->read<u8>();
+        const u64 tmp = input_stream->read<u8>();
         buffer |= tmp << bits_available;
         bits_available += 8;
     }
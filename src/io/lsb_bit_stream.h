@@ -2,16 +2,28 @@
 
 #include "io/base_bit_stream.h"
 #include "io/base_byte_stream.h"
+#include "io/bit_reader.h"
 
 namespace au {
 namespace io {
 
+    // When constructed from a buffer, reads it through a BitReader;
+    // otherwise fetches one byte at a time, so that the byte stream can be
+    // read in between.
     class LsbBitStream final : public BaseBitStream
     {
     public:
         LsbBitStream(const bstr &input);
         LsbBitStream(io::BaseByteStream &input_stream);
+
+        size_t tell() const override;
+        size_t size() const override;
+        BaseStream &seek(const size_t offset) override;
         u32 read(const size_t n) override;
+
+    private:
+        bslice data;
+        BitReader<BitOrder::Lsb> reader;
     };
 
 } }
@@ -0,0 +1,174 @@
+#include "io/mapped_file_stream.h"
+#include <cstring>
+#include "err.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace au;
+using namespace au::io;
+
+struct MappedFileStream::Mapping final
+{
+    Mapping(const io::path &path);
+    ~Mapping();
+
+    const u8 *data;
+    size_t size;
+};
+
+#ifdef _WIN32
+    MappedFileStream::Mapping::Mapping(const io::path &path)
+        : data(nullptr), size(0)
+    {
+        const auto file = CreateFileW(
+            path.wstr().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw err::FileNotFoundError("Could not open " + path.str());
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            throw err::IoError("Could not get size of " + path.str());
+        }
+        size = file_size.QuadPart;
+        if (!size)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        const auto mapping = CreateFileMappingW(
+            file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+            throw err::IoError("Could not map " + path.str());
+        data = reinterpret_cast<const u8*>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data)
+            throw err::IoError("Could not map " + path.str());
+    }
+
+    MappedFileStream::Mapping::~Mapping()
+    {
+        if (data)
+            UnmapViewOfFile(data);
+    }
+#else
+    MappedFileStream::Mapping::Mapping(const io::path &path)
+        : data(nullptr), size(0)
+    {
+        const auto fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw err::FileNotFoundError("Could not open " + path.str());
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            close(fd);
+            throw err::IoError("Could not get size of " + path.str());
+        }
+        size = file_stat.st_size;
+        if (!size)
+        {
+            close(fd);
+            return;
+        }
+
+        const auto ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED)
+            throw err::IoError("Could not map " + path.str());
+        data = reinterpret_cast<const u8*>(ptr);
+    }
+
+    MappedFileStream::Mapping::~Mapping()
+    {
+        if (data)
+            munmap(const_cast<u8*>(data), size);
+    }
+#endif
+
+MappedFileStream::MappedFileStream(
+    const std::shared_ptr<const Mapping> mapping)
+    : mapping(mapping), pos(0)
+{
+}
+
+MappedFileStream::MappedFileStream(const path &path)
+    : MappedFileStream(std::make_shared<const Mapping>(path))
+{
+}
+
+MappedFileStream::~MappedFileStream()
+{
+}
+
+void MappedFileStream::seek_impl(const size_t offset)
+{
+    if (offset > mapping->size)
+        throw err::EofError();
+    pos = offset;
+}
+
+void MappedFileStream::read_impl(void *destination, const size_t size)
+{
+    // destination MUST exist and size MUST be at least 1
+    if (pos + size > mapping->size)
+        throw err::EofError();
+    std::memcpy(destination, mapping->data + pos, size);
+    pos += size;
+}
+
+bslice MappedFileStream::read_slice(const size_t size)
+{
+    if (pos + size > mapping->size)
+        throw err::EofError();
+    const auto ret = bslice(mapping, mapping->data + pos, size);
+    pos += size;
+    return ret;
+}
+
+void MappedFileStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Writing to mapped files is not supported");
+}
+
+void MappedFileStream::truncate_impl(const size_t new_size)
+{
+    if (new_size == size())
+        return;
+    throw err::NotSupportedError("Truncating mapped files is not supported");
+}
+
+size_t MappedFileStream::tell() const
+{
+    return pos;
+}
+
+size_t MappedFileStream::size() const
+{
+    return mapping->size;
+}
+
+std::unique_ptr<BaseByteStream> MappedFileStream::clone() const
+{
+    auto ret = std::unique_ptr<MappedFileStream>(
+        new MappedFileStream(mapping));
+    ret->seek(tell());
+    return std::move(ret);
+}
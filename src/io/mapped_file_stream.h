@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include "io/base_byte_stream.h"
+#include "io/path.h"
+
+namespace au {
+namespace io {
+
+    // Read-only file stream backed by a memory mapping. Clones share the
+    // mapping, so cloning doesn't reopen the file.
+    class MappedFileStream final : public BaseByteStream
+    {
+    public:
+        MappedFileStream(const path &path);
+        ~MappedFileStream();
+
+        size_t size() const override;
+        size_t tell() const override;
+
+        bslice read_slice(const size_t bytes) override;
+
+        std::unique_ptr<BaseByteStream> clone() const override;
+
+    protected:
+        void read_impl(void *destination, const size_t size) override;
+        void write_impl(const void *source, const size_t size) override;
+        void seek_impl(const size_t offset) override;
+        void truncate_impl(const size_t new_size) override;
+
+    private:
+        struct Mapping;
+
+        MappedFileStream(const std::shared_ptr<const Mapping> mapping);
+
+        std::shared_ptr<const Mapping> mapping;
+        size_t pos;
+    };
+
+} }
@@ -19,18 +19,23 @@ MemoryStream::MemoryStream(const bstr &buffer)
 {
 }
 
+MemoryStream::MemoryStream(const bslice &buffer)
+    : slice(buffer), buffer_pos(0)
+{
+}
+
 MemoryStream::MemoryStream(const char *buffer, const size_t buffer_size)
     : MemoryStream(std::make_shared<bstr>(buffer, buffer_size))
 {
 }
 
 MemoryStream::MemoryStream(io::BaseByteStream &other, const size_t size)
-    : MemoryStream(std::make_shared<bstr>(other.read(size)))
+    : MemoryStream(other.read_slice(size))
 {
 }
 
 MemoryStream::MemoryStream(io::BaseByteStream &other)
-    : MemoryStream(std::make_shared<bstr>(other.read_to_eof()))
+    : MemoryStream(other.read_slice(other.left()))
 {
 }
 
@@ -38,16 +43,42 @@ MemoryStream::~MemoryStream()
 {
 }
 
+const u8 *MemoryStream::data() const
+{
+    return buffer ? buffer->get<const u8>() : slice.get<u8>();
+}
+
+void MemoryStream::make_writable()
+{
+    if (buffer)
+        return;
+    buffer = std::make_shared<bstr>(slice);
+    slice = bslice();
+}
+
 io::BaseByteStream &MemoryStream::reserve(const size_t size)
 {
+    make_writable();
     if (buffer->size() < size)
         buffer->resize(size);
     return *this;
 }
 
+bslice MemoryStream::read_slice(const size_t size)
+{
+    // slices of a writable buffer would observe subsequent writes
+    if (buffer)
+        return BaseByteStream::read_slice(size);
+    if (buffer_pos + size > slice.size())
+        throw err::EofError();
+    const auto ret = slice.substr(buffer_pos, size);
+    buffer_pos += size;
+    return ret;
+}
+
 void MemoryStream::seek_impl(const size_t offset)
 {
-    if (offset > buffer->size())
+    if (offset > this->size())
         throw err::EofError();
     buffer_pos = offset;
 }
@@ -55,9 +86,9 @@ void MemoryStream::seek_impl(const size_t offset)
 void MemoryStream::read_impl(void *destination, const size_t size)
 {
     // destination MUST exist and size MUST be at least 1
-    if (buffer_pos + size > buffer->size())
+    if (buffer_pos + size > this->size())
         throw err::EofError();
-    auto source_ptr = buffer->get<const u8>() + buffer_pos;
+    auto source_ptr = data() + buffer_pos;
     auto destination_ptr = reinterpret_cast<u8*>(destination);
     buffer_pos += size;
     std::memcpy(destination_ptr, source_ptr, size);
@@ -80,11 +111,12 @@ size_t MemoryStream::tell() const
 
 size_t MemoryStream::size() const
 {
-    return buffer->size();
+    return buffer ? buffer->size() : slice.size();
 }
 
 void MemoryStream::truncate_impl(const size_t new_size)
 {
+    make_writable();
     buffer->resize(new_size);
     if (buffer_pos > new_size)
         buffer_pos = new_size;
@@ -92,7 +124,9 @@ void MemoryStream::truncate_impl(const size_t new_size)
 
 std::unique_ptr<io::BaseByteStream> MemoryStream::clone() const
 {
-    auto ret = std::unique_ptr<MemoryStream>(new MemoryStream(buffer));
+    auto ret = buffer
+        ? std::unique_ptr<MemoryStream>(new MemoryStream(buffer))
+        : std::make_unique<MemoryStream>(slice);
     ret->seek(tell());
     return std::move(ret);
 }
@@ -14,6 +14,7 @@ namespace io {
         MemoryStream();
         MemoryStream(const char *buffer, const size_t buffer_size);
         MemoryStream(const bstr &buffer);
+        MemoryStream(const bslice &buffer);
         MemoryStream(BaseByteStream &other_stream, const size_t size);
         MemoryStream(BaseByteStream &other_stream);
         ~MemoryStream();
@@ -23,6 +24,8 @@ namespace io {
 
         BaseByteStream &reserve(const size_t count);
 
+        bslice read_slice(const size_t bytes) override;
+
         std::unique_ptr<BaseByteStream> clone() const override;
 
     protected:
@@ -33,8 +36,12 @@ namespace io {
 
     private:
         MemoryStream(const std::shared_ptr<bstr> buffer);
+        const u8 *data() const;
+        void make_writable();
 
+        // when wrapping a slice, the buffer is created on first write
         std::shared_ptr<bstr> buffer;
+        bslice slice;
         size_t buffer_pos;
     };
 
@@ -1,10 +1,13 @@
 #include "io/msb_bit_stream.h"
+#include "err.h"
 
 using namespace au;
 using namespace au::io;
 
-MsbBitStream::MsbBitStream(const bstr &input)
-    : BaseBitStream(input), dirty(false)
+MsbBitStream::MsbBitStream(const bstr &input) :
+    dirty(false),
+    data(input),
+    reader(data.get<u8>(), data.size())
 {
 }
 
@@ -18,6 +21,24 @@ MsbBitStream::~MsbBitStream()
     flush();
 }
 
+size_t MsbBitStream::tell() const
+{
+    return input_stream ? BaseBitStream::tell() : reader.tell();
+}
+
+size_t MsbBitStream::size() const
+{
+    return input_stream ? BaseBitStream::size() : reader.size();
+}
+
+BaseStream &MsbBitStream::seek(const size_t offset)
+{
+    if (input_stream)
+        return BaseBitStream::seek(offset);
+    reader.seek(offset);
+    return *this;
+}
+
 void MsbBitStream::flush()
 {
     if (dirty)
@@ -29,6 +50,8 @@ void MsbBitStream::flush()
 
 u32 MsbBitStream::read(const size_t bits)
 {
+    if (!input_stream)
+        return reader.read(bits);
     while (bits_available < bits)
     {
         const auto tmp = input_stream->read<u8>();
@@ -43,6 +66,8 @@ u32 MsbBitStream::read(const size_t bits)
 
 void MsbBitStream::write(const size_t bits, const u32 value)
 {
+    if (!input_stream)
+        throw err::NotSupportedError("Writing requires a byte stream");
     const auto mask = (1ull << bits) - 1;
     buffer <<= bits;
     buffer |= value & mask;
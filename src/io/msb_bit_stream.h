@@ -2,21 +2,32 @@
 
 #include "io/base_bit_stream.h"
 #include "io/base_byte_stream.h"
+#include "io/bit_reader.h"
 
 namespace au {
 namespace io {
 
+    // When constructed from a buffer, reads it through a BitReader;
+    // otherwise fetches one byte at a time, so that the byte stream can be
+    // read in between. Writing needs a byte stream.
     class MsbBitStream final : public BaseBitStream
     {
     public:
         MsbBitStream(const bstr &input);
         MsbBitStream(io::BaseByteStream &input_stream);
         ~MsbBitStream();
+
+        size_t tell() const override;
+        size_t size() const override;
+        BaseStream &seek(const size_t offset) override;
         u32 read(const size_t bits) override;
         void flush() override;
         void write(const size_t bits, const u32 value) override;
+
     private:
         bool dirty;
+        bslice data;
+        BitReader<BitOrder::Msb> reader;
     };
 
 } }
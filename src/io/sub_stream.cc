@@ -0,0 +1,77 @@
+#include "io/sub_stream.h"
+#include <cstring>
+#include "err.h"
+
+using namespace au;
+using namespace au::io;
+
+SubStream::SubStream(
+    const BaseByteStream &parent_stream,
+    const size_t offset,
+    const size_t size) :
+        parent_stream(parent_stream.clone()),
+        offset(offset),
+        sub_size(size),
+        pos(0)
+{
+    if (offset + size > this->parent_stream->size())
+        throw err::EofError();
+    this->parent_stream->seek(offset);
+}
+
+SubStream::~SubStream()
+{
+}
+
+void SubStream::seek_impl(const size_t offset)
+{
+    if (offset > sub_size)
+        throw err::EofError();
+    parent_stream->seek(this->offset + offset);
+    pos = offset;
+}
+
+void SubStream::read_impl(void *destination, const size_t size)
+{
+    if (pos + size > sub_size)
+        throw err::EofError();
+    const auto chunk = parent_stream->read_slice(size);
+    std::memcpy(destination, chunk.get<u8>(), size);
+    pos += size;
+}
+
+bslice SubStream::read_slice(const size_t size)
+{
+    if (pos + size > sub_size)
+        throw err::EofError();
+    const auto ret = parent_stream->read_slice(size);
+    pos += size;
+    return ret;
+}
+
+void SubStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Writing to sub streams is not supported");
+}
+
+void SubStream::truncate_impl(const size_t new_size)
+{
+    throw err::NotSupportedError("Truncating sub streams is not supported");
+}
+
+size_t SubStream::tell() const
+{
+    return pos;
+}
+
+size_t SubStream::size() const
+{
+    return sub_size;
+}
+
+std::unique_ptr<BaseByteStream> SubStream::clone() const
+{
+    auto ret = std::make_unique<SubStream>(*parent_stream, offset, sub_size);
+    ret->seek(tell());
+    return std::move(ret);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include "io/base_byte_stream.h"
+
+namespace au {
+namespace io {
+
+    // Read-only view over a range of another stream. Reading from it doesn't
+    // move the parent stream, since the view works on a clone of its own.
+    class SubStream final : public BaseByteStream
+    {
+    public:
+        SubStream(
+            const BaseByteStream &parent_stream,
+            const size_t offset,
+            const size_t size);
+        ~SubStream();
+
+        size_t size() const override;
+        size_t tell() const override;
+
+        bslice read_slice(const size_t bytes) override;
+
+        std::unique_ptr<BaseByteStream> clone() const override;
+
+    protected:
+        void read_impl(void *destination, const size_t size) override;
+        void write_impl(const void *source, const size_t size) override;
+        void seek_impl(const size_t offset) override;
+        void truncate_impl(const size_t new_size) override;
+
+    private:
+        std::unique_ptr<BaseByteStream> parent_stream;
+        size_t offset;
+        size_t sub_size;
+        size_t pos;
+    };
+
+} }
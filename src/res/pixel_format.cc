@@ -2,6 +2,7 @@
 #include <cstring>
 #include "algo/format.h"
 #include "algo/range.h"
+#include "res/pixel_format_simd.h"
 
 namespace au {
 namespace res {
@@ -238,6 +239,13 @@ namespace res {
         return c;
     }
 
+    template<PixelFormat fmt> static void read_pixels_scalar(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+    {
+        for (const auto i : algo::range(count))
+            output_ptr[i] = read_pixel<fmt>(input_ptr);
+    }
+
     void read_pixels(
         const u8 *input_ptr, std::vector<Pixel> &output, const PixelFormat fmt)
     {
@@ -250,35 +258,42 @@ namespace res {
 
         // I don't think there is a better alternative to this
         using PF = PixelFormat;
-        std::function<void(const u8 *, std::vector<Pixel> &)> impl;
+        void (*impl)(const u8 *, Pixel *, const size_t);
         switch (fmt)
         {
-            case PF::Gray8:     impl = read_pixels<PF::Gray8>; break;
-            case PF::BGR555X:   impl = read_pixels<PF::BGR555X>; break;
-            case PF::BGR565:    impl = read_pixels<PF::BGR565>; break;
-            case PF::BGR888:    impl = read_pixels<PF::BGR888>; break;
-            case PF::BGR888X:   impl = read_pixels<PF::BGR888X>; break;
-            case PF::BGRA4444:  impl = read_pixels<PF::BGRA4444>; break;
-            case PF::BGRA5551:  impl = read_pixels<PF::BGRA5551>; break;
-            case PF::BGRA8888:  impl = read_pixels<PF::BGRA8888>; break;
-            case PF::BGRnA4444: impl = read_pixels<PF::BGRnA4444>; break;
-            case PF::BGRnA5551: impl = read_pixels<PF::BGRnA5551>; break;
-            case PF::BGRnA8888: impl = read_pixels<PF::BGRnA8888>; break;
-            case PF::RGB555X:   impl = read_pixels<PF::RGB555X>; break;
-            case PF::RGB565:    impl = read_pixels<PF::RGB565>; break;
-            case PF::RGB888:    impl = read_pixels<PF::RGB888>; break;
-            case PF::RGB888X:   impl = read_pixels<PF::RGB888X>; break;
-            case PF::RGBA4444:  impl = read_pixels<PF::RGBA4444>; break;
-            case PF::RGBA5551:  impl = read_pixels<PF::RGBA5551>; break;
-            case PF::RGBA8888:  impl = read_pixels<PF::RGBA8888>; break;
-            case PF::RGBnA4444: impl = read_pixels<PF::RGBnA4444>; break;
-            case PF::RGBnA5551: impl = read_pixels<PF::RGBnA5551>; break;
-            case PF::RGBnA8888: impl = read_pixels<PF::RGBnA8888>; break;
+            case PF::Gray8:     impl = read_pixels_scalar<PF::Gray8>; break;
+            case PF::BGR555X:   impl = read_pixels_scalar<PF::BGR555X>; break;
+            case PF::BGR565:    impl = read_pixels_scalar<PF::BGR565>; break;
+            case PF::BGR888:    impl = read_pixels_scalar<PF::BGR888>; break;
+            case PF::BGR888X:   impl = read_pixels_scalar<PF::BGR888X>; break;
+            case PF::BGRA4444:  impl = read_pixels_scalar<PF::BGRA4444>; break;
+            case PF::BGRA5551:  impl = read_pixels_scalar<PF::BGRA5551>; break;
+            case PF::BGRA8888:  impl = read_pixels_scalar<PF::BGRA8888>; break;
+            case PF::BGRnA4444: impl = read_pixels_scalar<PF::BGRnA4444>; break;
+            case PF::BGRnA5551: impl = read_pixels_scalar<PF::BGRnA5551>; break;
+            case PF::BGRnA8888: impl = read_pixels_scalar<PF::BGRnA8888>; break;
+            case PF::RGB555X:   impl = read_pixels_scalar<PF::RGB555X>; break;
+            case PF::RGB565:    impl = read_pixels_scalar<PF::RGB565>; break;
+            case PF::RGB888:    impl = read_pixels_scalar<PF::RGB888>; break;
+            case PF::RGB888X:   impl = read_pixels_scalar<PF::RGB888X>; break;
+            case PF::RGBA4444:  impl = read_pixels_scalar<PF::RGBA4444>; break;
+            case PF::RGBA5551:  impl = read_pixels_scalar<PF::RGBA5551>; break;
+            case PF::RGBA8888:  impl = read_pixels_scalar<PF::RGBA8888>; break;
+            case PF::RGBnA4444: impl = read_pixels_scalar<PF::RGBnA4444>; break;
+            case PF::RGBnA5551: impl = read_pixels_scalar<PF::RGBnA5551>; break;
+            case PF::RGBnA8888: impl = read_pixels_scalar<PF::RGBnA8888>; break;
             default:
                 throw std::logic_error(
                     algo::format("Unsupported pixel format: %d", fmt));
         }
-        impl(input_ptr, output);
+
+        // the vector kernels leave a few trailing pixels to the scalar code
+        const auto done = read_pixels_simd(
+            input_ptr, output.data(), output.size(), fmt, get_simd_level());
+        impl(
+            input_ptr + done * pixel_format_to_bpp(fmt),
+            output.data() + done,
+            output.size() - done);
     }
 
 } }
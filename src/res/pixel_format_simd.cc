@@ -0,0 +1,440 @@
+#include "res/pixel_format_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__) \
+    || defined(_M_X64) || defined(_M_IX86)
+    #define AU_RES_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+// GCC and Clang only allow the intrinsics in functions compiled for the
+// matching instruction set; MSVC allows them everywhere
+#ifdef __GNUC__
+    #define AU_RES_TARGET(name) __attribute__((target(name)))
+#else
+    #define AU_RES_TARGET(name)
+#endif
+
+using namespace au;
+using namespace au::res;
+
+#ifdef AU_RES_X86
+
+namespace
+{
+    using Kernel = size_t (*)(const u8 *, Pixel *, const size_t);
+
+    // Packed 16-bit pixels: each color field is masked and moved by the
+    // given amount to its byte of a BGRA pixel. The alpha has 0, 1 or 4
+    // bits in the top of the word.
+    template<
+        u32 mask0_, int shift0_,
+        u32 mask1_, int shift1_,
+        u32 mask2_, int shift2_,
+        int alpha_bits_,
+        bool inverted_alpha_>
+    struct Packed16 final
+    {
+        static constexpr u32 mask0 = mask0_;
+        static constexpr int shift0 = shift0_;
+        static constexpr u32 mask1 = mask1_;
+        static constexpr int shift1 = shift1_;
+        static constexpr u32 mask2 = mask2_;
+        static constexpr int shift2 = shift2_;
+        static constexpr int alpha_bits = alpha_bits_;
+        static constexpr bool inverted_alpha = inverted_alpha_;
+    };
+
+    using PackedBGR555X
+        = Packed16<0x001F, 3, 0x03E0, 6, 0x7C00, 9, 0, false>;
+    using PackedBGR565
+        = Packed16<0x001F, 3, 0x07E0, 5, 0xF800, 8, 0, false>;
+    using PackedBGRA4444
+        = Packed16<0x000F, 4, 0x00F0, 8, 0x0F00, 12, 4, false>;
+    using PackedBGRA5551
+        = Packed16<0x001F, 3, 0x03E0, 6, 0x7C00, 9, 1, false>;
+    using PackedBGRnA4444
+        = Packed16<0x000F, 4, 0x00F0, 8, 0x0F00, 12, 4, true>;
+    using PackedBGRnA5551
+        = Packed16<0x001F, 3, 0x03E0, 6, 0x7C00, 9, 1, true>;
+    using PackedRGB555X
+        = Packed16<0x001F, 19, 0x03E0, 6, 0x7C00, -7, 0, false>;
+    using PackedRGB565
+        = Packed16<0x001F, 19, 0x07E0, 5, 0xF800, -8, 0, false>;
+    using PackedRGBA4444
+        = Packed16<0x000F, 20, 0x00F0, 8, 0x0F00, -4, 4, false>;
+    using PackedRGBA5551
+        = Packed16<0x001F, 19, 0x03E0, 6, 0x7C00, -7, 1, false>;
+    using PackedRGBnA4444
+        = Packed16<0x000F, 20, 0x00F0, 8, 0x0F00, -4, 4, true>;
+    using PackedRGBnA5551
+        = Packed16<0x001F, 19, 0x03E0, 6, 0x7C00, -7, 1, true>;
+}
+
+static const u32 alpha_mask = 0xFF000000;
+
+template<typename V, typename T> static const V *as_vector(const T *ptr)
+{
+    return reinterpret_cast<const V*>(ptr);
+}
+
+template<typename V, typename T> static V *as_vector(T *ptr)
+{
+    return reinterpret_cast<V*>(ptr);
+}
+
+// SSE2
+
+template<int shift> static AU_RES_TARGET("sse2")
+    __m128i shift_sse2(const __m128i x)
+{
+    return shift >= 0
+        ? _mm_slli_epi32(x, shift >= 0 ? shift : 0)
+        : _mm_srli_epi32(x, shift < 0 ? -shift : 0);
+}
+
+static AU_RES_TARGET("sse2") __m128i set1_sse2(const u32 value)
+{
+    return _mm_set1_epi32(static_cast<int>(value));
+}
+
+static AU_RES_TARGET("sse2") size_t read_gray_sse2(
+    const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    const auto opaque = _mm_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto x = _mm_loadu_si128(as_vector<__m128i>(input_ptr + i));
+        const auto xx_lo = _mm_unpacklo_epi8(x, x);
+        const auto xx_hi = _mm_unpackhi_epi8(x, x);
+        const auto xa_lo = _mm_unpacklo_epi8(x, opaque);
+        const auto xa_hi = _mm_unpackhi_epi8(x, opaque);
+        const auto output = as_vector<__m128i>(output_ptr + i);
+        _mm_storeu_si128(output + 0, _mm_unpacklo_epi16(xx_lo, xa_lo));
+        _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(xx_lo, xa_lo));
+        _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(xx_hi, xa_hi));
+        _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(xx_hi, xa_hi));
+    }
+    return i;
+}
+
+// takes zero extended 16-bit pixels
+template<typename F> static AU_RES_TARGET("sse2")
+    __m128i convert_packed16_sse2(const __m128i x)
+{
+    auto output = _mm_or_si128(
+        _mm_or_si128(
+            shift_sse2<F::shift0>(_mm_and_si128(x, set1_sse2(F::mask0))),
+            shift_sse2<F::shift1>(_mm_and_si128(x, set1_sse2(F::mask1)))),
+        shift_sse2<F::shift2>(_mm_and_si128(x, set1_sse2(F::mask2))));
+    if (F::alpha_bits == 0)
+        return _mm_or_si128(output, set1_sse2(alpha_mask));
+    // spread the top bit over the alpha byte
+    const auto alpha = F::alpha_bits == 1
+        ? _mm_srai_epi32(_mm_slli_epi32(x, 16), 7)
+        : _mm_slli_epi32(x, 16);
+    output = _mm_or_si128(output, _mm_and_si128(alpha, set1_sse2(
+        F::alpha_bits == 1 ? alpha_mask : 0xF0000000)));
+    if (F::inverted_alpha)
+        output = _mm_xor_si128(output, set1_sse2(alpha_mask));
+    return output;
+}
+
+template<typename F> static AU_RES_TARGET("sse2") size_t read_packed16_sse2(
+    const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    const auto zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto x = _mm_loadu_si128(as_vector<__m128i>(input_ptr + i * 2));
+        const auto output = as_vector<__m128i>(output_ptr + i);
+        _mm_storeu_si128(
+            output + 0,
+            convert_packed16_sse2<F>(_mm_unpacklo_epi16(x, zero)));
+        _mm_storeu_si128(
+            output + 1,
+            convert_packed16_sse2<F>(_mm_unpackhi_epi16(x, zero)));
+    }
+    return i;
+}
+
+template<bool swap, u32 alpha_or, u32 alpha_xor>
+    static AU_RES_TARGET("sse2") size_t read_32bit_sse2(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    const auto red_blue_mask = set1_sse2(0x00FF00FF);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto x = _mm_loadu_si128(as_vector<__m128i>(input_ptr + i * 4));
+        if (swap)
+        {
+            const auto red_blue = _mm_and_si128(x, red_blue_mask);
+            x = _mm_or_si128(
+                _mm_andnot_si128(red_blue_mask, x),
+                _mm_or_si128(
+                    _mm_slli_epi32(red_blue, 16),
+                    _mm_srli_epi32(red_blue, 16)));
+        }
+        x = _mm_or_si128(x, set1_sse2(alpha_or));
+        x = _mm_xor_si128(x, set1_sse2(alpha_xor));
+        _mm_storeu_si128(as_vector<__m128i>(output_ptr + i), x);
+    }
+    return i;
+}
+
+// AVX2
+
+template<int shift> static AU_RES_TARGET("avx2")
+    __m256i shift_avx2(const __m256i x)
+{
+    return shift >= 0
+        ? _mm256_slli_epi32(x, shift >= 0 ? shift : 0)
+        : _mm256_srli_epi32(x, shift < 0 ? -shift : 0);
+}
+
+static AU_RES_TARGET("avx2") __m256i set1_avx2(const u32 value)
+{
+    return _mm256_set1_epi32(static_cast<int>(value));
+}
+
+static AU_RES_TARGET("avx2") size_t read_gray_avx2(
+    const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    // replicates the first byte of every pixel into the color bytes
+    const auto spread = _mm256_setr_epi8(
+        0, 0, 0, -1, 4, 4, 4, -1, 8, 8, 8, -1, 12, 12, 12, -1,
+        0, 0, 0, -1, 4, 4, 4, -1, 8, 8, 8, -1, 12, 12, 12, -1);
+    const auto opaque = set1_avx2(alpha_mask);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const auto x = _mm_loadu_si128(as_vector<__m128i>(input_ptr + i));
+        const auto lo = _mm256_cvtepu8_epi32(x);
+        const auto hi = _mm256_cvtepu8_epi32(_mm_srli_si128(x, 8));
+        const auto output = as_vector<__m256i>(output_ptr + i);
+        _mm256_storeu_si256(
+            output + 0,
+            _mm256_or_si256(_mm256_shuffle_epi8(lo, spread), opaque));
+        _mm256_storeu_si256(
+            output + 1,
+            _mm256_or_si256(_mm256_shuffle_epi8(hi, spread), opaque));
+    }
+    return i;
+}
+
+// takes zero extended 16-bit pixels
+template<typename F> static AU_RES_TARGET("avx2")
+    __m256i convert_packed16_avx2(const __m256i x)
+{
+    auto output = _mm256_or_si256(
+        _mm256_or_si256(
+            shift_avx2<F::shift0>(_mm256_and_si256(x, set1_avx2(F::mask0))),
+            shift_avx2<F::shift1>(_mm256_and_si256(x, set1_avx2(F::mask1)))),
+        shift_avx2<F::shift2>(_mm256_and_si256(x, set1_avx2(F::mask2))));
+    if (F::alpha_bits == 0)
+        return _mm256_or_si256(output, set1_avx2(alpha_mask));
+    const auto alpha = F::alpha_bits == 1
+        ? _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 7)
+        : _mm256_slli_epi32(x, 16);
+    output = _mm256_or_si256(output, _mm256_and_si256(alpha, set1_avx2(
+        F::alpha_bits == 1 ? alpha_mask : 0xF0000000)));
+    if (F::inverted_alpha)
+        output = _mm256_xor_si256(output, set1_avx2(alpha_mask));
+    return output;
+}
+
+template<typename F> static AU_RES_TARGET("avx2") size_t read_packed16_avx2(
+    const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto x = _mm_loadu_si128(as_vector<__m128i>(input_ptr + i * 2));
+        _mm256_storeu_si256(
+            as_vector<__m256i>(output_ptr + i),
+            convert_packed16_avx2<F>(_mm256_cvtepu16_epi32(x)));
+    }
+    return i;
+}
+
+template<bool swap> static AU_RES_TARGET("avx2") size_t read_24bit_avx2(
+    const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    // each lane gets four pixels from the first 12 of its 16 bytes
+    const auto shuffle = swap
+        ? _mm256_setr_epi8(
+            2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+            2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+        : _mm256_setr_epi8(
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const auto opaque = set1_avx2(alpha_mask);
+    size_t i = 0;
+    // the second load reads 4 bytes past the 8 pixels
+    for (; i + 10 <= count; i += 8)
+    {
+        const auto ptr = input_ptr + i * 3;
+        const auto x = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(as_vector<__m128i>(ptr))),
+            _mm_loadu_si128(as_vector<__m128i>(ptr + 12)),
+            1);
+        _mm256_storeu_si256(
+            as_vector<__m256i>(output_ptr + i),
+            _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), opaque));
+    }
+    return i;
+}
+
+template<bool swap, u32 alpha_or, u32 alpha_xor>
+    static AU_RES_TARGET("avx2") size_t read_32bit_avx2(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    const auto shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto x = _mm256_loadu_si256(as_vector<__m256i>(input_ptr + i * 4));
+        if (swap)
+            x = _mm256_shuffle_epi8(x, shuffle);
+        x = _mm256_or_si256(x, set1_avx2(alpha_or));
+        x = _mm256_xor_si256(x, set1_avx2(alpha_xor));
+        _mm256_storeu_si256(as_vector<__m256i>(output_ptr + i), x);
+    }
+    return i;
+}
+
+static Kernel get_sse2_kernel(const PixelFormat fmt)
+{
+    using PF = PixelFormat;
+    switch (fmt)
+    {
+        case PF::Gray8:     return read_gray_sse2;
+        case PF::BGR555X:   return read_packed16_sse2<PackedBGR555X>;
+        case PF::BGR565:    return read_packed16_sse2<PackedBGR565>;
+        case PF::BGR888X:   return read_32bit_sse2<false, alpha_mask, 0>;
+        case PF::BGRA4444:  return read_packed16_sse2<PackedBGRA4444>;
+        case PF::BGRA5551:  return read_packed16_sse2<PackedBGRA5551>;
+        case PF::BGRA8888:  return read_32bit_sse2<false, 0, 0>;
+        case PF::BGRnA4444: return read_packed16_sse2<PackedBGRnA4444>;
+        case PF::BGRnA5551: return read_packed16_sse2<PackedBGRnA5551>;
+        case PF::BGRnA8888: return read_32bit_sse2<false, 0, alpha_mask>;
+        case PF::RGB555X:   return read_packed16_sse2<PackedRGB555X>;
+        case PF::RGB565:    return read_packed16_sse2<PackedRGB565>;
+        case PF::RGB888X:   return read_32bit_sse2<true, alpha_mask, 0>;
+        case PF::RGBA4444:  return read_packed16_sse2<PackedRGBA4444>;
+        case PF::RGBA5551:  return read_packed16_sse2<PackedRGBA5551>;
+        case PF::RGBA8888:  return read_32bit_sse2<true, 0, 0>;
+        case PF::RGBnA4444: return read_packed16_sse2<PackedRGBnA4444>;
+        case PF::RGBnA5551: return read_packed16_sse2<PackedRGBnA5551>;
+        case PF::RGBnA8888: return read_32bit_sse2<true, 0, alpha_mask>;
+        // 24-bit pixels need byte shuffles, which SSE2 doesn't have
+        default: return nullptr;
+    }
+}
+
+static Kernel get_avx2_kernel(const PixelFormat fmt)
+{
+    using PF = PixelFormat;
+    switch (fmt)
+    {
+        case PF::Gray8:     return read_gray_avx2;
+        case PF::BGR555X:   return read_packed16_avx2<PackedBGR555X>;
+        case PF::BGR565:    return read_packed16_avx2<PackedBGR565>;
+        case PF::BGR888:    return read_24bit_avx2<false>;
+        case PF::BGR888X:   return read_32bit_avx2<false, alpha_mask, 0>;
+        case PF::BGRA4444:  return read_packed16_avx2<PackedBGRA4444>;
+        case PF::BGRA5551:  return read_packed16_avx2<PackedBGRA5551>;
+        case PF::BGRA8888:  return read_32bit_avx2<false, 0, 0>;
+        case PF::BGRnA4444: return read_packed16_avx2<PackedBGRnA4444>;
+        case PF::BGRnA5551: return read_packed16_avx2<PackedBGRnA5551>;
+        case PF::BGRnA8888: return read_32bit_avx2<false, 0, alpha_mask>;
+        case PF::RGB555X:   return read_packed16_avx2<PackedRGB555X>;
+        case PF::RGB565:    return read_packed16_avx2<PackedRGB565>;
+        case PF::RGB888:    return read_24bit_avx2<true>;
+        case PF::RGB888X:   return read_32bit_avx2<true, alpha_mask, 0>;
+        case PF::RGBA4444:  return read_packed16_avx2<PackedRGBA4444>;
+        case PF::RGBA5551:  return read_packed16_avx2<PackedRGBA5551>;
+        case PF::RGBA8888:  return read_32bit_avx2<true, 0, 0>;
+        case PF::RGBnA4444: return read_packed16_avx2<PackedRGBnA4444>;
+        case PF::RGBnA5551: return read_packed16_avx2<PackedRGBnA5551>;
+        case PF::RGBnA8888: return read_32bit_avx2<true, 0, alpha_mask>;
+        default: return nullptr;
+    }
+}
+
+static SimdLevel detect_simd_level()
+{
+    #if defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return SimdLevel::Sse2;
+        return SimdLevel::None;
+    #elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const auto max_leaf = info[0];
+        __cpuid(info, 1);
+        const auto has_sse2 = (info[3] & (1 << 26)) != 0;
+        // the OS must also save the upper halves of the AVX registers
+        const auto has_os_avx = (info[2] & (1 << 27)) != 0
+            && (_xgetbv(0) & 6) == 6;
+        if (max_leaf >= 7 && has_os_avx)
+        {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5))
+                return SimdLevel::Avx2;
+        }
+        return has_sse2 ? SimdLevel::Sse2 : SimdLevel::None;
+    #else
+        return SimdLevel::None;
+    #endif
+}
+
+SimdLevel res::get_simd_level()
+{
+    static const auto level = detect_simd_level();
+    return level;
+}
+
+size_t res::read_pixels_simd(
+    const u8 *input_ptr,
+    Pixel *output_ptr,
+    const size_t count,
+    const PixelFormat fmt,
+    const SimdLevel level)
+{
+    Kernel kernel = nullptr;
+    if (level == SimdLevel::Avx2)
+        kernel = get_avx2_kernel(fmt);
+    else if (level == SimdLevel::Sse2)
+        kernel = get_sse2_kernel(fmt);
+    return kernel ? kernel(input_ptr, output_ptr, count) : 0;
+}
+
+#else
+
+SimdLevel res::get_simd_level()
+{
+    return SimdLevel::None;
+}
+
+size_t res::read_pixels_simd(
+    const u8 *input_ptr,
+    Pixel *output_ptr,
+    const size_t count,
+    const PixelFormat fmt,
+    const SimdLevel level)
+{
+    return 0;
+}
+
+#endif
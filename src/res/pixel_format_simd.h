@@ -0,0 +1,29 @@
+#pragma once
+
+#include "res/pixel.h"
+#include "res/pixel_format.h"
+
+namespace au {
+namespace res {
+
+    enum class SimdLevel : u8
+    {
+        None,
+        Sse2,
+        Avx2,
+    };
+
+    // the best instruction set supported by both the build and the CPU
+    SimdLevel get_simd_level();
+
+    // Converts the leading pixels with the vector instructions of the given
+    // level, which mustn't exceed get_simd_level(), and returns how many of
+    // them were converted. The remaining ones are left to the scalar code.
+    size_t read_pixels_simd(
+        const u8 *input_ptr,
+        Pixel *output_ptr,
+        const size_t count,
+        const PixelFormat fmt,
+        const SimdLevel level);
+
+} }
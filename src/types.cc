@@ -1,5 +1,6 @@
 #include "types.h"
 #include <algorithm>
+#include <cstring>
 
 using namespace au;
 
@@ -25,6 +26,10 @@ bstr::bstr(const std::string &other) : v(other.begin(), other.end())
 {
 }
 
+bstr::bstr(const bslice &other) : v(other.begin(), other.end())
+{
+}
+
 const char *bstr::c_str() const
 {
     return get<const char>();
@@ -168,3 +173,69 @@ const u8 &bstr::at(const size_t pos) const
 {
     return v.at(pos);
 }
+
+bslice::bslice() : data(nullptr), data_size(0)
+{
+}
+
+bslice::bslice(const bstr &other) : bslice(bstr(other))
+{
+}
+
+bslice::bslice(bstr &&other)
+{
+    const auto buffer = std::make_shared<const bstr>(std::move(other));
+    owner = buffer;
+    data = buffer->get<const u8>();
+    data_size = buffer->size();
+}
+
+bslice::bslice(
+    const std::shared_ptr<const void> owner,
+    const u8 *data,
+    const size_t size) :
+        owner(owner),
+        data(data),
+        data_size(size)
+{
+}
+
+bool bslice::empty() const
+{
+    return data_size == 0;
+}
+
+size_t bslice::size() const
+{
+    return data_size;
+}
+
+bslice bslice::substr(const size_t start) const
+{
+    if (start > data_size)
+        return bslice();
+    return bslice(owner, data + start, data_size - start);
+}
+
+bslice bslice::substr(const size_t start, const size_t size) const
+{
+    if (start > data_size)
+        return bslice();
+    return bslice(owner, data + start, std::min(size, data_size - start));
+}
+
+bool bslice::operator ==(const bslice &other) const
+{
+    return data_size == other.data_size
+        && (!data_size || !std::memcmp(data, other.data, data_size));
+}
+
+bool bslice::operator !=(const bslice &other) const
+{
+    return !(*this == other);
+}
+
+const u8 &bslice::operator [](const size_t pos) const
+{
+    return data[pos];
+}
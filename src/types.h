@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,8 @@ namespace au {
     using f32 = float;
     using f64 = double;
 
+    struct bslice;
+
     struct bstr final
     {
         static const size_t npos;
@@ -25,6 +28,7 @@ namespace au {
         bstr();
         bstr(const size_t n, u8 fill = 0);
         bstr(const std::string &other);
+        bstr(const bslice &other);
         bstr(const u8 *str, const size_t size);
         bstr(const char *str, const size_t size);
 
@@ -100,6 +104,54 @@ namespace au {
         std::vector<u8> v;
     };
 
+    // Immutable view over a reference-counted buffer. Copying slices and
+    // taking their substrings never copies the underlying data.
+    struct bslice final
+    {
+        bslice();
+        bslice(const bstr &other);
+        bslice(bstr &&other);
+        bslice(
+            const std::shared_ptr<const void> owner,
+            const u8 *data,
+            const size_t size);
+
+        bool empty() const;
+        size_t size() const;
+
+        bslice substr(const size_t start) const;
+        bslice substr(const size_t start, const size_t size) const;
+
+        template<typename T> const T *get() const
+        {
+            return reinterpret_cast<const T*>(data);
+        }
+
+        template<typename T> const T *end() const
+        {
+            return data ? get<T>() + data_size / sizeof(T) : nullptr;
+        }
+
+        const u8 *begin() const
+        {
+            return get<u8>();
+        }
+
+        const u8 *end() const
+        {
+            return end<u8>();
+        }
+
+        bool operator ==(const bslice &other) const;
+        bool operator !=(const bslice &other) const;
+        const u8 &operator [](const size_t pos) const;
+
+    private:
+        std::shared_ptr<const void> owner;
+        const u8 *data;
+        size_t data_size;
+    };
+
     constexpr u8 operator "" _u8(char value)
     {
         return static_cast<u8>(value);
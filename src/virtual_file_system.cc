@@ -2,26 +2,117 @@
 #include <map>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
+#include <unordered_map>
 #include "algo/str.h"
 #include "err.h"
 #include "io/file_system.h"
 
 using namespace au;
 
-static std::mutex mutex;
-static std::map<io::path, std::function<std::unique_ptr<io::File>()>> factories;
-static std::set<io::path> directories;
+namespace
+{
+    using FileFactory = std::function<std::unique_ptr<io::File>()>;
+
+    // contents of a registered directory, keyed by lowercased stem, name
+    // and path; only the first file found for each key is kept
+    struct DirectoryIndex final
+    {
+        DirectoryIndex(const io::path &directory);
+
+        std::unordered_map<std::string, io::path> by_stem;
+        std::unordered_map<std::string, io::path> by_name;
+        std::map<io::path, io::path> by_path;
+    };
+}
+
+static std::shared_timed_mutex mutex;
+static std::map<io::path, FileFactory> factories;
+static std::unordered_map<std::string, std::set<io::path>> factories_by_stem;
+static std::unordered_map<std::string, std::set<io::path>> factories_by_name;
+// directories are scanned lazily, on the first lookup after they get
+// registered, and their index lives until they get unregistered
+static std::map<io::path, std::unique_ptr<DirectoryIndex>> directories;
 static bool enabled = true;
 
+DirectoryIndex::DirectoryIndex(const io::path &directory)
+{
+    for (const auto &path : io::recursive_directory_range(directory))
+    {
+        by_stem.insert({algo::lower(path.stem()), path});
+        by_name.insert({algo::lower(path.name()), path});
+        by_path.insert({io::path(algo::lower(path.str())), path});
+    }
+}
+
+static void scan_directories()
+{
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        bool all_scanned = true;
+        for (const auto &kv : directories)
+            all_scanned &= kv.second != nullptr;
+        if (all_scanned)
+            return;
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    for (auto &kv : directories)
+        if (!kv.second)
+            kv.second = std::make_unique<DirectoryIndex>(kv.first);
+}
+
+static void add_to_index(
+    std::unordered_map<std::string, std::set<io::path>> &index,
+    const std::string &key,
+    const io::path &path)
+{
+    index[key].insert(path);
+}
+
+static void remove_from_index(
+    std::unordered_map<std::string, std::set<io::path>> &index,
+    const std::string &key,
+    const io::path &path)
+{
+    const auto it = index.find(key);
+    if (it == index.end())
+        return;
+    it->second.erase(path);
+    if (it->second.empty())
+        index.erase(it);
+}
+
+template<typename T, typename K> static io::path find_in_directories(
+    T DirectoryIndex::*index, const K &key)
+{
+    for (const auto &kv : directories)
+    {
+        // registered after the last scan
+        if (!kv.second)
+            continue;
+        const auto &paths = (*kv.second).*index;
+        const auto it = paths.find(key);
+        if (it != paths.end())
+            return it->second;
+    }
+    return io::path();
+}
+
+static std::unique_ptr<io::File> open_file(const io::path &path)
+{
+    return std::make_unique<io::File>(path, io::FileMode::Read);
+}
+
 void VirtualFileSystem::disable()
 {
-    std::unique_lock<std::mutex> lock(mutex);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
     enabled = false;
 }
 
 void VirtualFileSystem::enable()
 {
-    std::unique_lock<std::mutex> lock(mutex);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
     enabled = true;
 }
 
@@ -29,86 +120,100 @@ void VirtualFileSystem::register_file(
     const io::path &path,
     const std::function<std::unique_ptr<io::File>()> factory)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (enabled)
-        factories[io::path(algo::lower(path.str()))] = factory;
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    if (!enabled)
+        return;
+    const auto key = io::path(algo::lower(path.str()));
+    factories[key] = factory;
+    add_to_index(factories_by_stem, key.stem(), key);
+    add_to_index(factories_by_name, key.name(), key);
 }
 
 void VirtualFileSystem::unregister_file(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    factories.erase(io::path(algo::lower(path.str())));
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
+    const auto key = io::path(algo::lower(path.str()));
+    if (!factories.erase(key))
+        return;
+    remove_from_index(factories_by_stem, key.stem(), key);
+    remove_from_index(factories_by_name, key.name(), key);
 }
 
 void VirtualFileSystem::register_directory(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
+    // drop the previous index, so that files created since get found
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
     if (enabled)
-        directories.insert(path);
+        directories[path] = nullptr;
 }
 
 void VirtualFileSystem::unregister_directory(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
+    std::unique_lock<std::shared_timed_mutex> lock(mutex);
     directories.erase(path);
 }
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
     const std::string &stem)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
-        return nullptr;
-
-    const auto check = algo::lower(stem);
-    for (const auto &kv : factories)
-        if (kv.first.stem() == check)
-            return kv.second();
+    scan_directories();
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
-        if (algo::lower(other_path.stem()) == check)
-            return std::make_unique<io::File>(other_path, io::FileMode::Read);
+    io::path file_path;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        if (!enabled)
+            return nullptr;
+
+        const auto check = algo::lower(stem);
+        // factories are invoked under the lock, so that they cannot get
+        // unregistered while running
+        const auto it = factories_by_stem.find(check);
+        if (it != factories_by_stem.end())
+            return factories.at(*it->second.begin())();
+        file_path = find_in_directories(&DirectoryIndex::by_stem, check);
+    }
 
-    return nullptr;
+    // unlike factories, files on disk can be opened without holding the lock
+    return file_path.str().empty() ? nullptr : open_file(file_path);
 }
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_name(
     const std::string &name)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
-        return nullptr;
+    scan_directories();
 
-    const auto check = algo::lower(name);
-    for (const auto &kv : factories)
-        if (kv.first.name() == check)
-            return kv.second();
-
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
-        if (algo::lower(other_path.name()) == check)
-            return std::make_unique<io::File>(other_path, io::FileMode::Read);
+    io::path file_path;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        if (!enabled)
+            return nullptr;
+
+        const auto check = algo::lower(name);
+        const auto it = factories_by_name.find(check);
+        if (it != factories_by_name.end())
+            return factories.at(*it->second.begin())();
+        file_path = find_in_directories(&DirectoryIndex::by_name, check);
+    }
 
-    return nullptr;
+    return file_path.str().empty() ? nullptr : open_file(file_path);
 }
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_path(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
-        return nullptr;
-
-    const auto check = io::path(algo::lower(path.str()));
-    if (factories.find(check) != factories.end())
-        return factories[check]();
+    scan_directories();
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
+    io::path file_path;
     {
-        if (io::path(algo::lower(other_path.str())) == check)
-            return std::make_unique<io::File>(other_path, io::FileMode::Read);
+        std::shared_lock<std::shared_timed_mutex> lock(mutex);
+        if (!enabled)
+            return nullptr;
+
+        const auto check = io::path(algo::lower(path.str()));
+        const auto it = factories.find(check);
+        if (it != factories.end())
+            return it->second();
+        file_path = find_in_directories(&DirectoryIndex::by_path, check);
     }
 
-    return nullptr;
+    return file_path.str().empty() ? nullptr : open_file(file_path);
 }
@@ -18,6 +18,8 @@ namespace au {
             const std::function<std::unique_ptr<io::File>()> factory);
         static void unregister_file(const io::path &path);
 
+        // The directory is scanned on the first lookup after registering
+        // it, so registering it again picks up the files added since.
         static void register_directory(const io::path &path);
         static void unregister_directory(const io::path &path);
 
@@ -33,4 +33,38 @@ TEST_CASE("Converting text encoding", "[algo]")
     {
         REQUIRE(algo::utf8_to_sjis(utf8) == sjis);
     }
+
+    SECTION("Converting ASCII")
+    {
+        REQUIRE(algo::sjis_to_utf8("abc\\x~\x00"_b) == "abc\\x~\x00"_b);
+        REQUIRE(algo::utf8_to_sjis("abc\\x~\x00"_b) == "abc\\x~\x00"_b);
+        REQUIRE(algo::utf8_to_utf16("ab"_b) == "a\x00" "b\x00"_b);
+        REQUIRE(algo::utf16_to_utf8("a\x00" "b\x00"_b) == "ab"_b);
+    }
+
+    SECTION("Converting half-width katakana")
+    {
+        // sjis "ｱ.ﾝ"
+        REQUIRE(algo::sjis_to_utf8("\xB1.\xDD"_b)
+            == "\xEF\xBD\xB1.\xEF\xBE\x9D"_b);
+        REQUIRE(algo::utf8_to_sjis("\xEF\xBD\xB1.\xEF\xBE\x9D"_b)
+            == "\xB1.\xDD"_b);
+    }
+
+    SECTION("Converting UTF16")
+    {
+        // utf16 "あa"
+        REQUIRE(algo::utf16_to_utf8("\x42\x30\x61\x00"_b)
+            == "\xE3\x81\x82\x61"_b);
+        REQUIRE(algo::utf8_to_utf16("\xE3\x81\x82\x61"_b)
+            == "\x42\x30\x61\x00"_b);
+    }
+
+    SECTION("Recovering from invalid input")
+    {
+        REQUIRE_THROWS(algo::sjis_to_utf8("\x82"_b));
+        REQUIRE(algo::sjis_to_utf8(sjis) == utf8);
+        REQUIRE_THROWS(algo::utf8_to_sjis("\xE3\x81"_b));
+        REQUIRE(algo::utf8_to_sjis(utf8) == sjis);
+    }
 }
@@ -0,0 +1,127 @@
+#include "algo/pack/huffman.h"
+#include "algo/range.h"
+#include "io/memory_stream.h"
+#include "io/msb_bit_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo::pack;
+
+namespace
+{
+    struct Code final
+    {
+        u32 bits;
+        size_t size;
+    };
+}
+
+// symbols from the first range get the shortest codes; splitting off one
+// symbol at a time makes a degenerate tree with codes as long as needed
+static void write_tree(
+    io::BaseBitStream &output,
+    std::vector<Code> &codes,
+    const size_t first,
+    const size_t last,
+    const bool degenerate,
+    const Code prefix)
+{
+    if (last - first == 1)
+    {
+        output.write(1, 0);
+        output.write(8, first);
+        codes[first] = prefix;
+        return;
+    }
+    const auto middle = degenerate ? first + 1 : (first + last) / 2;
+    output.write(1, 1);
+    write_tree(
+        output, codes, first, middle, degenerate,
+        {prefix.bits << 1, prefix.size + 1});
+    write_tree(
+        output, codes, middle, last, degenerate,
+        {(prefix.bits << 1) | 1, prefix.size + 1});
+}
+
+static void test_decoding(
+    const size_t symbol_count, const bool degenerate, const bstr &expected)
+{
+    std::vector<Code> codes(256);
+    io::MemoryStream tree_stream;
+    {
+        io::MsbBitStream tree_writer(tree_stream);
+        write_tree(tree_writer, codes, 0, symbol_count, degenerate, {0, 0});
+    }
+    const HuffmanTree tree(tree_stream.seek(0).read_to_eof());
+
+    io::MemoryStream data_stream;
+    {
+        io::MsbBitStream data_writer(data_stream);
+        for (const auto c : expected)
+        {
+            // codes longer than 32 bits are written in parts
+            auto size = codes[c].size;
+            while (size > 32)
+            {
+                data_writer.write(32, 0xFFFFFFFF);
+                size -= 32;
+            }
+            data_writer.write(size, codes[c].bits);
+        }
+    }
+    const auto input = data_stream.seek(0).read_to_eof();
+    const auto actual = decode_huffman(tree, input, expected.size());
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("Huffman decoding", "[algo][pack]")
+{
+    // long enough for the lookup tables to get used
+    bstr input(5000);
+    for (const auto i : algo::range(input.size()))
+        input[i] = (i * i + i / 7) % 23;
+
+    SECTION("Codes fitting in the primary table")
+    {
+        test_decoding(23, false, input);
+    }
+
+    SECTION("Codes spanning several tables")
+    {
+        test_decoding(23, true, input);
+    }
+
+    SECTION("Codes longer than 32 bits")
+    {
+        for (const auto i : algo::range(input.size()))
+            input[i] = i % 3 ? 0 : 200 + i % 55;
+        test_decoding(256, true, input);
+    }
+
+    SECTION("Short outputs")
+    {
+        test_decoding(23, false, input.substr(0, 100));
+        test_decoding(23, true, input.substr(0, 100));
+    }
+
+    SECTION("Decoding stops at the end of the input")
+    {
+        // 1, 0 'a', 0 'b'
+        const HuffmanTree tree("\x98\x4C\x40"_b);
+        REQUIRE(decode_huffman(tree, "\x5A"_b, 100) == "ababbaba"_b);
+        REQUIRE(decode_huffman(tree, "\x5A"_b, 3) == "aba"_b);
+
+        bstr long_input(3000, '\x5A');
+        bstr expected;
+        for (const auto i : algo::range(long_input.size()))
+            expected += "ababbaba"_b;
+        REQUIRE(decode_huffman(tree, long_input, 100000) == expected);
+    }
+
+    SECTION("Single symbol trees")
+    {
+        const HuffmanTree tree("\x30\x80"_b); // 0, 'a'
+        REQUIRE(decode_huffman(tree, "\x00"_b, 5) == "aaaaa"_b);
+        REQUIRE(decode_huffman(tree, ""_b, 5) == ""_b);
+    }
+}
@@ -1,5 +1,7 @@
 #include "algo/pack/lzss.h"
 #include "algo/range.h"
+#include "io/memory_stream.h"
+#include "io/msb_bit_stream.h"
 #include "test_support/catch.h"
 
 using namespace au;
@@ -31,6 +33,51 @@ static void test_bytes(const bstr &input, size_t size)
     test_bytes(input, bstr(size, 'a'));
 }
 
+static bstr make_random_input(const size_t size, u32 seed)
+{
+    bstr output(size);
+    for (const auto i : algo::range(size))
+    {
+        seed = seed * 1103515245 + 12345;
+        output[i] = seed >> 16;
+    }
+    return output;
+}
+
+// straightforward decompressor that keeps a separate cyclic dictionary
+static bstr reference_decompress(
+    const bstr &input,
+    const size_t output_size,
+    const size_t position_bits,
+    const size_t size_bits,
+    const size_t min_match_size,
+    const size_t initial_dictionary_pos)
+{
+    io::MsbBitStream input_stream(input);
+    std::vector<u8> dict(1 << position_bits);
+    auto dict_pos = initial_dictionary_pos;
+    bstr output;
+    while (output.size() < output_size)
+    {
+        if (input_stream.read(1))
+        {
+            const u8 c = input_stream.read(8);
+            output += c;
+            dict[dict_pos++ % dict.size()] = c;
+            continue;
+        }
+        auto match_pos = input_stream.read(position_bits);
+        auto match_size = input_stream.read(size_bits) + min_match_size;
+        while (match_size-- && output.size() < output_size)
+        {
+            const u8 c = dict[match_pos++ % dict.size()];
+            output += c;
+            dict[dict_pos++ % dict.size()] = c;
+        }
+    }
+    return output;
+}
+
 TEST_CASE("LZSS unpacking", "[algo][pack]")
 {
     SECTION("Bitwise")
@@ -94,6 +141,75 @@ TEST_CASE("LZSS unpacking", "[algo][pack]")
     }
 }
 
+TEST_CASE("LZSS unpacking of random data", "[algo][pack]")
+{
+    // any input is a valid stream; small dictionaries make for short and
+    // overlapping distances as well as references to the initial zeros
+    for (const auto position_bits : {4, 8, 12})
+    for (const auto initial_dictionary_pos : {0, 1, 0xFEE})
+    {
+        const auto input = make_random_input(5000, position_bits);
+        // each literal or match takes at most 17 bits
+        const auto output_size = input.size() * 8 / 17;
+        INFO("Position bits: " << position_bits);
+        INFO("Initial position: " << initial_dictionary_pos);
+
+        BitwiseLzssSettings settings;
+        settings.position_bits = position_bits;
+        settings.size_bits = 4;
+        settings.min_match_size = 2;
+        settings.initial_dictionary_pos = initial_dictionary_pos;
+        REQUIRE(lzss_decompress(input, output_size, settings)
+            == reference_decompress(
+                input, output_size, position_bits, 4, 2,
+                initial_dictionary_pos));
+
+        // bytewise streams are the bitwise ones with the control bits
+        // gathered into bytes, hence comparing to a different reference
+        if (position_bits != 12)
+            continue;
+        BytewiseLzssSettings bytewise_settings;
+        bytewise_settings.initial_dictionary_pos = initial_dictionary_pos;
+        const auto actual
+            = lzss_decompress(input, output_size, bytewise_settings);
+        io::MemoryStream converted;
+        {
+            io::MsbBitStream bit_stream(converted);
+            size_t pos = 0;
+            while (pos < input.size())
+            {
+                const auto control = input[pos++];
+                for (const auto i : algo::range(8))
+                {
+                    if (pos >= input.size())
+                        break;
+                    if (control & (1 << i))
+                    {
+                        bit_stream.write(1, 1);
+                        bit_stream.write(8, input[pos++]);
+                        continue;
+                    }
+                    if (pos + 1 >= input.size())
+                        break;
+                    const auto lo = input[pos++];
+                    const auto hi = input[pos++];
+                    bit_stream.write(1, 0);
+                    bit_stream.write(12, lo | ((hi & 0xF0) << 4));
+                    bit_stream.write(4, hi & 0xF);
+                }
+            }
+        }
+        const auto expected = reference_decompress(
+            converted.seek(0).read_to_eof(),
+            output_size,
+            12,
+            4,
+            3,
+            initial_dictionary_pos);
+        REQUIRE(actual == expected);
+    }
+}
+
 TEST_CASE("LZSS packing", "[algo][pack]")
 {
     SECTION("Bitwise")
@@ -133,3 +249,62 @@ TEST_CASE("LZSS packing", "[algo][pack]")
         REQUIRE(lzss_decompress(x, input.size(), settings) == input);
     }
 }
+
+TEST_CASE("LZSS packing at all effort levels", "[algo][pack]")
+{
+    // repetitive enough to compress, with leading zeros that can refer to
+    // the initial dictionary contents
+    bstr input(300);
+    for (const auto i : algo::range(3000))
+        input += static_cast<u8>('a' + (i * i) % 7);
+    input += make_random_input(1000, 1);
+    input += bstr(5000, 'x');
+
+    const auto efforts
+        = {LzssEffort::Fast, LzssEffort::Normal, LzssEffort::Best};
+
+    SECTION("Bitwise")
+    {
+        for (const auto effort : efforts)
+        for (const auto position_bits : {4, 12, 16})
+        for (const auto initial_dictionary_pos : {0, 1, 0xFEE})
+        {
+            INFO("Effort: " << static_cast<int>(effort));
+            INFO("Position bits: " << position_bits);
+            INFO("Initial position: " << initial_dictionary_pos);
+            BitwiseLzssSettings settings;
+            settings.position_bits = position_bits;
+            settings.size_bits = 4;
+            settings.min_match_size = 2;
+            settings.initial_dictionary_pos = initial_dictionary_pos;
+            const auto output = lzss_compress(input, settings, effort);
+            REQUIRE(output.size() < input.size() / 2);
+            REQUIRE(lzss_decompress(output, input.size(), settings) == input);
+        }
+    }
+
+    SECTION("Bytewise")
+    {
+        for (const auto effort : efforts)
+        {
+            INFO("Effort: " << static_cast<int>(effort));
+            BytewiseLzssSettings settings;
+            const auto output = lzss_compress(input, settings, effort);
+            REQUIRE(output.size() < input.size() / 2);
+            REQUIRE(lzss_decompress(output, input.size(), settings) == input);
+        }
+    }
+
+    SECTION("Higher effort doesn't compress worse")
+    {
+        BytewiseLzssSettings settings;
+        const auto fast = lzss_compress(input, settings, LzssEffort::Fast);
+        const auto best = lzss_compress(input, settings, LzssEffort::Best);
+        REQUIRE(best.size() <= fast.size());
+    }
+
+    SECTION("Empty input")
+    {
+        REQUIRE(lzss_compress(""_b) == ""_b);
+    }
+}
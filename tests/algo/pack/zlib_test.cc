@@ -18,6 +18,25 @@ TEST_CASE("ZLIB compression", "[algo][pack]")
         REQUIRE(zlib_inflate(input) == output);
     }
 
+    SECTION("Inflating ZLIB with expected size")
+    {
+        REQUIRE(zlib_inflate(input, output.size()) == output);
+        REQUIRE(zlib_inflate(bslice(input), output.size()) == output);
+    }
+
+    SECTION("Inflating ZLIB with wrong expected size")
+    {
+        REQUIRE(zlib_inflate(input, 0) == output);
+        REQUIRE(zlib_inflate(input, output.size() - 1) == output);
+        REQUIRE(zlib_inflate(input, output.size() + 1) == output);
+        REQUIRE(zlib_inflate(input, 0xFFFFFFFF) == output);
+    }
+
+    SECTION("Inflating corrupt ZLIB with expected size")
+    {
+        REQUIRE_THROWS(zlib_inflate(input.substr(0, 10), output.size()));
+    }
+
     SECTION("Inflating ZLIB from stream")
     {
         io::MemoryStream input_stream(input);
@@ -29,4 +48,24 @@ TEST_CASE("ZLIB compression", "[algo][pack]")
     {
         REQUIRE(zlib_inflate(zlib_deflate(output)) == output);
     }
+
+    SECTION("Inflating ZLIB incrementally")
+    {
+        ZlibInflateStream stream(
+            std::make_unique<io::MemoryStream>(input), output.size());
+        REQUIRE(stream.size() == output.size());
+        REQUIRE(stream.read(5) == "life "_b);
+        REQUIRE(stream.read(3) == "is "_b);
+        REQUIRE(stream.seek(0).read(4) == "life"_b);
+        REQUIRE(stream.clone()->read_to_eof() == " is code\n"_b);
+        REQUIRE(stream.seek(8).read_to_eof() == "code\n"_b);
+        REQUIRE_THROWS(stream.read(1));
+    }
+
+    SECTION("Inflating ZLIB incrementally with bad size")
+    {
+        ZlibInflateStream stream(
+            std::make_unique<io::MemoryStream>(input), output.size() + 1);
+        REQUIRE_THROWS(stream.read_to_eof());
+    }
 }
@@ -0,0 +1,118 @@
+#include "algo/parallel.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <stdexcept>
+#include <vector>
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Parallel for", "[algo]")
+{
+    SECTION("Every index is visited exactly once")
+    {
+        std::vector<std::atomic<int>> visits(1000);
+        for (auto &visit : visits)
+            visit = 0;
+        algo::parallel_for(
+            visits.size(), [&](const size_t i) { ++visits[i]; }, 4);
+        for (const auto &visit : visits)
+            REQUIRE(visit == 1);
+    }
+
+    SECTION("No work")
+    {
+        algo::parallel_for(0, [](const size_t) { FAIL(); }, 4);
+    }
+
+    SECTION("Exceptions are propagated")
+    {
+        REQUIRE_THROWS_AS(
+            algo::parallel_for(
+                100,
+                [](const size_t i)
+                {
+                    if (i == 50)
+                        throw std::runtime_error("test");
+                },
+                4),
+            std::runtime_error);
+    }
+
+    SECTION("Thread budget")
+    {
+        std::mutex mutex;
+        std::set<std::thread::id> thread_ids;
+        const auto record_thread = [&](const size_t)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            thread_ids.insert(std::this_thread::get_id());
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        };
+
+        SECTION("Limited to the calling thread")
+        {
+            algo::set_thread_budget(1);
+            algo::parallel_for(100, record_thread, 4);
+            REQUIRE(thread_ids.size() == 1);
+            REQUIRE(*thread_ids.begin() == std::this_thread::get_id());
+        }
+
+        SECTION("Spare budget is used")
+        {
+            algo::set_thread_budget(4);
+            algo::parallel_for(100, record_thread, 4);
+            REQUIRE(thread_ids.size() > 1);
+            REQUIRE(thread_ids.size() <= 4);
+        }
+
+        SECTION("Busy threads take up the budget")
+        {
+            algo::set_thread_budget(2);
+            std::atomic<bool> started(false);
+            std::atomic<bool> done(false);
+            std::thread busy_thread([&]()
+            {
+                algo::BusyThreadScope busy;
+                started = true;
+                while (!done)
+                    std::this_thread::yield();
+            });
+            while (!started)
+                std::this_thread::yield();
+            algo::parallel_for(100, record_thread, 4);
+            done = true;
+            busy_thread.join();
+            REQUIRE(thread_ids.size() == 1);
+        }
+
+        SECTION("Nested calls stay within the budget")
+        {
+            algo::set_thread_budget(4);
+            std::atomic<int> active_count(0);
+            std::atomic<int> max_active_count(0);
+            algo::parallel_for(4, [&](const size_t)
+            {
+                algo::parallel_for(8, [&](const size_t)
+                {
+                    const int current = ++active_count;
+                    int max = max_active_count;
+                    while (current > max
+                        && !max_active_count.compare_exchange_weak(
+                            max, current))
+                    {
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    --active_count;
+                }, 4);
+            }, 4);
+            REQUIRE(max_active_count <= 4);
+        }
+
+        algo::set_thread_budget(0);
+    }
+}
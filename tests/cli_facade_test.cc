@@ -1,4 +1,5 @@
 #include "flow/cli_facade.h"
+#include "err.h"
 #include "io/file_system.h"
 #include "test_support/catch.h"
 
@@ -24,6 +25,23 @@ TEST_CASE("CLI facade", "[core]")
         io::remove("./AYU_03.png");
     }
 
+    SECTION("Choosing image output format with CLI facade")
+    {
+        const flow::CliFacade cli_facade(
+            logger,
+            {
+                "./tests/dec/real_live/files/g00/AYU_03.g00",
+                "--dec=real-live/g00",
+                "--image-format=qoi"
+            });
+
+        cli_facade.run();
+
+        REQUIRE(io::is_regular_file("./AYU_03.qoi"));
+        REQUIRE(!io::is_regular_file("./AYU_03.png"));
+        io::remove("./AYU_03.qoi");
+    }
+
     SECTION("Unpacking archives with CLI facade")
     {
         const flow::CliFacade cli_facade(
@@ -43,4 +61,35 @@ TEST_CASE("CLI facade", "[core]")
         io::remove("./xp3-v2~.xp3/123.txt");
         io::remove("./xp3-v2~.xp3");
     }
+
+    SECTION("Memory sizes above 2 GB are accepted")
+    {
+        const flow::CliFacade cli_facade(
+            logger,
+            {
+                "./tests/dec/real_live/files/g00/AYU_03.g00",
+                "--dec=real-live/g00",
+                "--max-memory=5000000000"
+            });
+
+        cli_facade.run();
+
+        REQUIRE(io::is_regular_file("./AYU_03.png"));
+        io::remove("./AYU_03.png");
+    }
+
+    SECTION("Malformed memory sizes are rejected")
+    {
+        for (const auto &size : {"512MB", "", "-5", "1.5G", "99999999999999G"})
+        {
+            REQUIRE_THROWS_AS(
+                flow::CliFacade(
+                    logger,
+                    {
+                        "./tests/dec/real_live/files/g00/AYU_03.g00",
+                        std::string("--max-memory=") + size
+                    }),
+                err::UsageError);
+        }
+    }
 }
@@ -0,0 +1,115 @@
+#include "dec/decoder_pool.h"
+#include "dec/base_file_decoder.h"
+#include "err.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::dec;
+
+namespace
+{
+    class TestDecoder final : public BaseFileDecoder
+    {
+    public:
+        TestDecoder();
+
+        std::string value;
+
+    protected:
+        bool is_recognized_impl(io::File &input_file) const override;
+
+        std::unique_ptr<io::File> decode_impl(
+            const Logger &logger, io::File &input_file) const override;
+    };
+}
+
+TestDecoder::TestDecoder()
+{
+    add_arg_parser_decorator(
+        [](ArgParser &arg_parser)
+        {
+            arg_parser.register_switch({"--value"})
+                ->set_value_name("VALUE")
+                ->set_description("Test value.");
+        },
+        [&](const ArgParser &arg_parser)
+        {
+            value = arg_parser.get_switch("value");
+            if (value == "bad")
+                throw err::UsageError("Bad value");
+        });
+}
+
+bool TestDecoder::is_recognized_impl(io::File &input_file) const
+{
+    return true;
+}
+
+std::unique_ptr<io::File> TestDecoder::decode_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    return nullptr;
+}
+
+static std::unique_ptr<Registry> create_registry(int &construction_count)
+{
+    auto registry = Registry::create_mock();
+    registry->add_decoder(
+        "test/test",
+        [&]()
+        {
+            ++construction_count;
+            return std::make_shared<TestDecoder>();
+        });
+    return registry;
+}
+
+TEST_CASE("Decoder pool", "[dec]")
+{
+    int construction_count = 0;
+    const auto registry = create_registry(construction_count);
+
+    SECTION("Shared decoders are constructed once")
+    {
+        const auto decoder1 = registry->get_decoder("test/test");
+        const auto decoder2 = registry->get_decoder("test/test");
+        REQUIRE(decoder1 == decoder2);
+        REQUIRE(construction_count == 1);
+    }
+
+    SECTION("Pooled decoders are configured once")
+    {
+        DecoderPool decoder_pool(*registry, {"--value=test"});
+        const auto decoder1 = decoder_pool.get_decoder("test/test");
+        const auto decoder2 = decoder_pool.get_decoder("test/test");
+        REQUIRE(decoder1 == decoder2);
+        REQUIRE(construction_count == 1);
+        REQUIRE(dynamic_cast<TestDecoder&>(*decoder1).value == "test");
+    }
+
+    SECTION("Pooled decoders don't share options with other runs")
+    {
+        DecoderPool decoder_pool1(*registry, {"--value=test1"});
+        DecoderPool decoder_pool2(*registry, {"--value=test2"});
+        const auto decoder1 = decoder_pool1.get_decoder("test/test");
+        const auto decoder2 = decoder_pool2.get_decoder("test/test");
+        REQUIRE(decoder1 != decoder2);
+        REQUIRE(dynamic_cast<TestDecoder&>(*decoder1).value == "test1");
+        REQUIRE(dynamic_cast<TestDecoder&>(*decoder2).value == "test2");
+    }
+
+    SECTION("Decoders that fail to configure are not pooled")
+    {
+        DecoderPool decoder_pool(*registry, {"--value=bad"});
+        REQUIRE_THROWS(decoder_pool.get_decoder("test/test"));
+        REQUIRE_THROWS(decoder_pool.get_decoder("test/test"));
+        REQUIRE(construction_count == 2);
+    }
+
+    SECTION("Unknown decoders")
+    {
+        DecoderPool decoder_pool(*registry, {});
+        REQUIRE_THROWS(decoder_pool.get_decoder("test/unknown"));
+        REQUIRE_THROWS(registry->get_decoder("test/unknown"));
+    }
+}
@@ -0,0 +1,104 @@
+#include "dec/registry.h"
+#include "dec/idecoder.h"
+#include "io/file.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::dec;
+
+static void add_dummy_decoder(Registry &registry, const std::string &name)
+{
+    registry.add_decoder(name, []() { return nullptr; });
+}
+
+TEST_CASE("Decoder registry", "[dec]")
+{
+    auto registry = Registry::create_mock();
+    add_dummy_decoder(*registry, "test/magic");
+    add_dummy_decoder(*registry, "test/magic-at-offset");
+    add_dummy_decoder(*registry, "test/extension");
+    add_dummy_decoder(*registry, "test/no-signature");
+    registry->add_signature(
+        "test/magic", DecoderSignature::from_magic("ABCD"_b));
+    registry->add_signature(
+        "test/magic-at-offset", DecoderSignature::from_magic("CD"_b, 2));
+    registry->add_signature(
+        "test/extension", DecoderSignature::from_extension("ext"));
+    const std::set<std::string> all_names = {
+        "test/magic",
+        "test/magic-at-offset",
+        "test/extension",
+        "test/no-signature",
+    };
+
+    SECTION("Matching magic")
+    {
+        io::File input_file("test.bin", "ABCDEF"_b);
+        input_file.stream.seek(3);
+        const auto names
+            = registry->get_plausible_decoder_names(input_file, all_names);
+        REQUIRE(names == (std::set<std::string>{
+            "test/magic", "test/magic-at-offset", "test/no-signature"}));
+        REQUIRE(input_file.stream.tell() == 3);
+    }
+
+    SECTION("Matching extension")
+    {
+        io::File input_file("test.EXT", "XYZ"_b);
+        const auto names
+            = registry->get_plausible_decoder_names(input_file, all_names);
+        REQUIRE(names == (std::set<std::string>{
+            "test/extension", "test/no-signature"}));
+    }
+
+    SECTION("Files shorter than magic")
+    {
+        io::File input_file("test.bin", "AB"_b);
+        const auto names
+            = registry->get_plausible_decoder_names(input_file, all_names);
+        REQUIRE(names == (std::set<std::string>{"test/no-signature"}));
+    }
+
+    SECTION("Names outside of the given set are ignored")
+    {
+        io::File input_file("test.ext", "ABCD"_b);
+        const auto names = registry->get_plausible_decoder_names(
+            input_file, {"test/magic"});
+        REQUIRE(names == (std::set<std::string>{"test/magic"}));
+    }
+
+    SECTION("Signatures of unknown decoders")
+    {
+        REQUIRE_THROWS(registry->add_signature(
+            "test/unknown", DecoderSignature::from_extension("ext")));
+    }
+}
+
+TEST_CASE("Decoder signatures never reject recognizable files", "[dec]")
+{
+    const auto &registry = Registry::instance();
+    std::set<std::string> all_names;
+    for (const auto &name : registry.get_decoder_names())
+        all_names.insert(name);
+
+    for (const auto &path : io::recursive_directory_range("tests/dec"))
+    {
+        if (!io::is_regular_file(path)
+            || path.str().find("/files/") == std::string::npos)
+        {
+            continue;
+        }
+        io::File input_file(path, io::FileMode::Read);
+        const auto plausible_names
+            = registry.get_plausible_decoder_names(input_file, all_names);
+        for (const auto &name : all_names)
+        {
+            if (plausible_names.find(name) != plausible_names.end())
+                continue;
+            input_file.stream.seek(0);
+            INFO(name << " rejects " << path.str());
+            REQUIRE(!registry.create_decoder(name)->is_recognized(input_file));
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "enc/png/png_image_encoder.h"
+#include "algo/parallel.h"
+#include "algo/range.h"
+#include "dec/png/png_image_decoder.h"
+#include "test_support/catch.h"
+#include "test_support/image_support.h"
+
+using namespace au;
+using namespace au::enc::png;
+
+static void test_encoding(const res::Image &input_image)
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto png_decoder = dec::png::PngImageDecoder();
+    for (const auto profile : {
+        PngProfile::Fastest, PngProfile::Balanced, PngProfile::Smallest})
+    {
+        const auto png_encoder = PngImageEncoder(profile);
+        const auto output_file
+            = png_encoder.encode(dummy_logger, input_image, "test.dat");
+        REQUIRE(output_file->path.name() == "test.png");
+        const auto output_image
+            = png_decoder.decode(dummy_logger, *output_file);
+        tests::compare_images(input_image, output_image);
+    }
+}
+
+static res::Image make_noisy_image(const size_t width, const size_t height)
+{
+    res::Image image(width, height);
+    for (const auto y : algo::range(height))
+    for (const auto x : algo::range(width))
+    {
+        auto &pixel = image.at(x, y);
+        pixel.b = x ^ y;
+        pixel.g = x * y;
+        pixel.r = (x + y) / 3;
+        pixel.a = (x * 7) ^ (y * 13);
+    }
+    return image;
+}
+
+TEST_CASE("PNG images encoding", "[enc]")
+{
+    SECTION("Small image")
+    {
+        res::Image input_image(1, 1);
+        input_image.at(0, 0) = {1, 2, 3, 4};
+        test_encoding(input_image);
+    }
+
+    SECTION("Bigger image")
+    {
+        test_encoding(tests::get_opaque_test_image());
+    }
+
+    SECTION("Image spanning many segments")
+    {
+        test_encoding(make_noisy_image(300, 700));
+    }
+
+    SECTION("Output doesn't depend on the thread budget")
+    {
+        Logger dummy_logger;
+        dummy_logger.mute();
+        const auto input_image = make_noisy_image(600, 600);
+        const auto png_encoder = PngImageEncoder(PngProfile::Balanced);
+        const auto encode = [&](const size_t thread_budget)
+        {
+            algo::set_thread_budget(thread_budget);
+            const auto output_file
+                = png_encoder.encode(dummy_logger, input_image, "test.dat");
+            algo::set_thread_budget(0);
+            return output_file->stream.seek(0).read_to_eof();
+        };
+        const auto expected_output = encode(1);
+        REQUIRE(!expected_output.empty());
+        REQUIRE(encode(4) == expected_output);
+        test_encoding(input_image);
+    }
+}
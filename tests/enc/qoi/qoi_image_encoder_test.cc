@@ -0,0 +1,47 @@
+#include "enc/qoi/qoi_image_encoder.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::enc::qoi;
+
+static res::Pixel rgba(const u8 r, const u8 g, const u8 b, const u8 a)
+{
+    return {b, g, r, a};
+}
+
+TEST_CASE("QOI images encoding", "[enc]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto qoi_encoder = QoiImageEncoder();
+
+    SECTION("All chunk types")
+    {
+        res::Image input_image(7, 1);
+        input_image.at(0, 0) = rgba(0, 0, 0, 0xFF);       // run
+        input_image.at(1, 0) = rgba(0, 0, 0, 0xFF);       // run
+        input_image.at(2, 0) = rgba(1, 1, 1, 0xFF);       // diff
+        input_image.at(3, 0) = rgba(11, 11, 11, 0xFF);    // luma
+        input_image.at(4, 0) = rgba(1, 1, 1, 0xFF);       // index
+        input_image.at(5, 0) = rgba(200, 0, 0, 0xFF);     // RGB
+        input_image.at(6, 0) = rgba(200, 0, 0, 0x80);     // RGBA
+        const auto output_file
+            = qoi_encoder.encode(dummy_logger, input_image, "test.dat");
+        REQUIRE(output_file->path.name() == "test.qoi");
+        REQUIRE(output_file->stream.seek(0).read_to_eof() ==
+            "qoif\x00\x00\x00\x07\x00\x00\x00\x01\x04\x00"
+            "\xC1\x7F\xAA\x88\x04\xFE\xC8\x00\x00\xFF\xC8\x00\x00\x80"
+            "\x00\x00\x00\x00\x00\x00\x00\x01"_b);
+    }
+
+    SECTION("Long runs")
+    {
+        res::Image input_image(100, 1);
+        for (auto &pixel : input_image)
+            pixel = rgba(0, 0, 0, 0xFF);
+        const auto output_file
+            = qoi_encoder.encode(dummy_logger, input_image, "test.dat");
+        REQUIRE(output_file->stream.seek(14).read_to_eof() ==
+            "\xFD\xE5\x00\x00\x00\x00\x00\x00\x00\x01"_b);
+    }
+}
@@ -0,0 +1,22 @@
+#include "enc/raw/bgra_image_encoder.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::enc::raw;
+
+TEST_CASE("Raw BGRA images encoding", "[enc]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto bgra_encoder = BgraImageEncoder();
+
+    res::Image input_image(2, 1);
+    input_image.at(0, 0) = {1, 2, 3, 4};
+    input_image.at(1, 0) = {5, 6, 7, 8};
+    const auto output_file
+        = bgra_encoder.encode(dummy_logger, input_image, "test.dat");
+    REQUIRE(output_file->path.name() == "test.bgra");
+    REQUIRE(output_file->stream.seek(0).read_to_eof() ==
+        "BGRA\x10\x00\x00\x00\x02\x00\x00\x00\x01\x00\x00\x00"
+        "\x01\x02\x03\x04\x05\x06\x07\x08"_b);
+}
@@ -0,0 +1,89 @@
+#include "flow/allocation_tracker.h"
+#include <memory>
+#include <thread>
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+// the compiler may drop allocations whose memory is never used
+static void *volatile last_allocation;
+
+static std::unique_ptr<u8[]> allocate(const size_t size)
+{
+    std::unique_ptr<u8[]> data(new u8[size]);
+    last_allocation = data.get();
+    return data;
+}
+
+TEST_CASE("Allocation tracker", "[flow]")
+{
+    SECTION("Counting allocations")
+    {
+        AllocationScope scope;
+        {
+            const auto a = allocate(1000);
+            const auto b = allocate(3000);
+        }
+        const auto c = allocate(2000);
+        // copied, since checking them can allocate memory too
+        const auto counters = scope.get_counters();
+        REQUIRE(counters.allocation_count == 3);
+        REQUIRE(counters.allocated_bytes >= 6000);
+        REQUIRE(counters.peak_live_bytes >= 4000);
+        REQUIRE(counters.peak_live_bytes < 6000);
+        REQUIRE(counters.live_bytes >= 2000);
+        REQUIRE(counters.live_bytes < 4000);
+    }
+
+    SECTION("Freeing memory allocated outside of the scope")
+    {
+        auto data = allocate(1000);
+        AllocationScope scope;
+        data.reset();
+        const auto counters = scope.get_counters();
+        REQUIRE(counters.allocation_count == 0);
+        REQUIRE(counters.live_bytes <= -1000);
+        REQUIRE(counters.peak_live_bytes == 0);
+    }
+
+    SECTION("Nested scopes")
+    {
+        size_t inner_count, outer_count;
+        {
+            AllocationScope outer_scope;
+            {
+                AllocationScope inner_scope;
+                const auto data = allocate(4);
+                inner_count = inner_scope.get_counters().allocation_count;
+            }
+            {
+                // leaves the counting to the outer scope
+                AllocationScope disabled_scope(false);
+                const auto data = allocate(4);
+            }
+            outer_count = outer_scope.get_counters().allocation_count;
+        }
+        REQUIRE(inner_count == 1);
+        REQUIRE(outer_count == 1);
+    }
+
+    SECTION("Other threads are not counted")
+    {
+        size_t count_before, count_after;
+        std::unique_ptr<u8[]> data;
+        {
+            AllocationScope scope;
+            std::thread thread([&]() { data = allocate(4); });
+            count_before = scope.get_counters().allocation_count;
+            thread.join();
+            count_after = scope.get_counters().allocation_count;
+        }
+        REQUIRE(count_before == count_after);
+    }
+
+    SECTION("Peak resident memory")
+    {
+        REQUIRE(get_peak_resident_memory() > 0);
+    }
+}
@@ -1,4 +1,6 @@
 ﻿#include "flow/file_saver_hdd.h"
+#include <set>
+#include "algo/parallel.h"
 #include "io/file_system.h"
 #include "test_support/catch.h"
 
@@ -78,4 +80,35 @@ TEST_CASE("FileSaver", "[core]")
         const flow::FileSaverHdd file_saver(".", true);
         do_test_overwriting(file_saver, file_saver, true);
     }
+
+    SECTION("Saving from many threads at once")
+    {
+        const io::path dir = "test-saver-dir";
+        const flow::FileSaverHdd file_saver(".", true);
+        std::vector<io::path> saved_paths(20);
+        try
+        {
+            algo::parallel_for(saved_paths.size(), [&](const size_t i)
+            {
+                const auto file = std::make_shared<io::File>(
+                    (dir / (i % 2 ? "a/test.txt" : "b/test.txt")).str(),
+                    "test"_b);
+                saved_paths[i] = file_saver.save(file);
+            }, 4);
+            REQUIRE(file_saver.get_saved_file_count() == 20);
+            REQUIRE(std::set<io::path>(saved_paths.begin(), saved_paths.end())
+                .size() == 20);
+            for (const auto &path : saved_paths)
+            {
+                io::FileStream file_stream(path, io::FileMode::Read);
+                REQUIRE(file_stream.read_to_eof() == "test"_b);
+            }
+            boost::filesystem::remove_all(dir.str());
+        }
+        catch (...)
+        {
+            boost::filesystem::remove_all(dir.str());
+            throw;
+        }
+    }
 }
@@ -0,0 +1,106 @@
+#include "flow/memory_budget.h"
+#include <cstdlib>
+#include "algo/range.h"
+#include "io/file_system.h"
+#include "io/memory_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+static std::shared_ptr<io::File> make_file(const size_t size)
+{
+    bstr content(size);
+    for (const auto i : algo::range(size))
+        content[i] = i * 7;
+    return std::make_shared<io::File>("test.dat", content);
+}
+
+TEST_CASE("Memory budget", "[flow]")
+{
+    Logger logger;
+    logger.mute();
+
+    SECTION("No limit")
+    {
+        MemoryBudget budget(0);
+        const auto file = make_file(1024);
+        REQUIRE(budget.hold(logger, file, true) == file);
+        REQUIRE(budget.get_used_memory() == 0);
+        REQUIRE(!budget.is_exceeded());
+    }
+
+    SECTION("Files are accounted for as long as they are held")
+    {
+        MemoryBudget budget(1000);
+        auto file1 = budget.hold(logger, make_file(600), false);
+        REQUIRE(budget.get_used_memory() == 600);
+        REQUIRE(!budget.is_exceeded());
+        auto file2 = budget.hold(logger, make_file(600), false);
+        REQUIRE(budget.get_used_memory() == 1200);
+        REQUIRE(budget.is_exceeded());
+        file1.reset();
+        REQUIRE(budget.get_used_memory() == 600);
+        REQUIRE(!budget.is_exceeded());
+        file2.reset();
+        REQUIRE(budget.get_used_memory() == 0);
+    }
+
+    SECTION("Files that don't fit are spilled to disk")
+    {
+        MemoryBudget budget(100 * 1024);
+        const auto input_file = make_file(200 * 1024);
+        const auto expected_content
+            = input_file->stream.seek(0).read_to_eof();
+
+        auto held_file = budget.hold(logger, input_file, true);
+        REQUIRE(held_file != input_file);
+        REQUIRE(held_file->path == input_file->path);
+        REQUIRE(!dynamic_cast<io::MemoryStream*>(&held_file->stream));
+        REQUIRE(held_file->stream.seek(0).read_to_eof() == expected_content);
+        REQUIRE(budget.get_used_memory() == 0);
+
+        held_file.reset();
+        REQUIRE(budget.get_used_memory() == 0);
+    }
+
+    SECTION("Spilling is optional")
+    {
+        MemoryBudget budget(100 * 1024);
+        const auto input_file = make_file(200 * 1024);
+        const auto held_file = budget.hold(logger, input_file, false);
+        REQUIRE(held_file.get() == input_file.get());
+        REQUIRE(budget.get_used_memory() == 200 * 1024);
+        REQUIRE(budget.is_exceeded());
+    }
+
+    SECTION("Held files can outlive the budget")
+    {
+        std::shared_ptr<io::File> held_file;
+        {
+            MemoryBudget budget(100 * 1024);
+            held_file = budget.hold(logger, make_file(200 * 1024), true);
+        }
+        REQUIRE(held_file->stream.size() == 200 * 1024);
+        held_file.reset();
+    }
+
+#ifndef _WIN32
+    SECTION("Files that fail to spill stay in memory")
+    {
+        const auto tmpdir = std::getenv("TMPDIR");
+        const std::string previous_tmpdir = tmpdir ? tmpdir : "";
+        setenv("TMPDIR", "./nonexistent-temp-dir", 1);
+        MemoryBudget budget(100 * 1024);
+        const auto input_file = make_file(200 * 1024);
+        const auto held_file = budget.hold(logger, input_file, true);
+        if (tmpdir)
+            setenv("TMPDIR", previous_tmpdir.c_str(), 1);
+        else
+            unsetenv("TMPDIR");
+        REQUIRE(held_file.get() == input_file.get());
+        REQUIRE(budget.get_used_memory() == 200 * 1024);
+        REQUIRE(!io::exists("./nonexistent-temp-dir"));
+    }
+#endif
+}
@@ -0,0 +1,343 @@
+#include "flow/pipeline.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "algo/format.h"
+#include "algo/parallel.h"
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    class CallbackTask final : public ITask
+    {
+    public:
+        CallbackTask(const std::function<bool()> callback);
+        bool work() const override;
+
+    private:
+        const std::function<bool()> callback;
+    };
+}
+
+CallbackTask::CallbackTask(const std::function<bool()> callback)
+    : callback(callback)
+{
+}
+
+bool CallbackTask::work() const
+{
+    return callback();
+}
+
+static std::shared_ptr<ITask> make_task(const std::function<bool()> callback)
+{
+    return std::make_shared<CallbackTask>(callback);
+}
+
+static std::vector<PipelineStage> make_stages(
+    const size_t thread_count, const size_t queue_capacity)
+{
+    return {
+        {"first", thread_count, queue_capacity},
+        {"second", thread_count, queue_capacity},
+        {"third", thread_count, queue_capacity},
+    };
+}
+
+TEST_CASE("Pipeline", "[flow]")
+{
+    SECTION("No tasks")
+    {
+        Pipeline pipeline(3);
+        const auto result = pipeline.run(make_stages(4, 4), 4);
+        REQUIRE(result.success_count == 0);
+        REQUIRE(result.error_count == 0);
+    }
+
+    SECTION("Counting results")
+    {
+        Pipeline pipeline(3);
+        for (const auto i : algo::range(100))
+        {
+            pipeline.push_back(0, make_task([&pipeline, i]()
+            {
+                pipeline.push_front(
+                    2, make_task([=]() { return i % 3 != 0; }));
+                return true;
+            }));
+        }
+        const auto result = pipeline.run(make_stages(4, 4), 4);
+        REQUIRE(result.success_count == 166);
+        REQUIRE(result.error_count == 34);
+    }
+
+    SECTION("Exceptions fail their tasks")
+    {
+        Pipeline pipeline(3);
+        for (const auto i : algo::range(10))
+        {
+            pipeline.push_back(0, make_task([=]() -> bool
+            {
+                if (i % 2)
+                    throw std::runtime_error("Test");
+                return true;
+            }));
+        }
+        const auto result = pipeline.run(make_stages(4, 4), 4);
+        REQUIRE(result.success_count == 5);
+        REQUIRE(result.error_count == 5);
+    }
+
+    SECTION("Order of execution with single thread")
+    {
+        Pipeline pipeline(3);
+        std::vector<int> order;
+        pipeline.push_back(0, make_task([&]()
+        {
+            order.push_back(1);
+            pipeline.push_front(2, make_task([&]()
+            {
+                order.push_back(4);
+                return true;
+            }));
+            pipeline.push_front(1, make_task([&]()
+            {
+                order.push_back(2);
+                pipeline.push_front(2, make_task([&]()
+                {
+                    order.push_back(3);
+                    return true;
+                }));
+                return true;
+            }));
+            return true;
+        }));
+        pipeline.push_back(
+            0, make_task([&]() { order.push_back(5); return true; }));
+        const auto result = pipeline.run(make_stages(1, 10), 1);
+        REQUIRE(result.success_count == 5);
+        REQUIRE(order == (std::vector<int>{1, 2, 3, 4, 5}));
+    }
+
+    SECTION("Stages respect their thread counts")
+    {
+        Pipeline pipeline(3);
+        std::atomic<int> running_count(0);
+        std::atomic<int> max_running_count(0);
+        for (const auto i : algo::range(50))
+        {
+            pipeline.push_back(1, make_task([&]()
+            {
+                const int current = ++running_count;
+                int max = max_running_count;
+                while (current > max
+                    && !max_running_count.compare_exchange_weak(max, current))
+                {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                --running_count;
+                return true;
+            }));
+        }
+        auto stages = make_stages(8, 8);
+        stages[1].thread_count = 2;
+        const auto result = pipeline.run(stages, 8);
+        REQUIRE(result.success_count == 50);
+        REQUIRE(max_running_count <= 2);
+    }
+
+    SECTION("Full queues hold back the earlier stages")
+    {
+        Pipeline pipeline(3);
+        const int queue_capacity = 3;
+        const int thread_count = 4;
+        std::atomic<int> waiting_count(0);
+        std::atomic<int> max_waiting_count(0);
+        std::atomic<int> executed_count(0);
+        pipeline.push_back(0, make_task([&]()
+        {
+            for (const auto i : algo::range(200))
+            {
+                pipeline.push_front(1, make_task([&]()
+                {
+                    --waiting_count;
+                    pipeline.push_front(2, make_task([&]()
+                    {
+                        ++executed_count;
+                        return true;
+                    }));
+                    return true;
+                }));
+                const int current = ++waiting_count;
+                if (current > max_waiting_count)
+                    max_waiting_count = current;
+            }
+            return true;
+        }));
+        const auto result
+            = pipeline.run(make_stages(thread_count, queue_capacity), 4);
+        REQUIRE(result.success_count == 401);
+        REQUIRE(executed_count == 200);
+        // tasks that were taken from the queue but didn't start yet are
+        // still counted as waiting
+        REQUIRE(max_waiting_count <= queue_capacity + thread_count);
+    }
+
+    SECTION("Throttling")
+    {
+        Pipeline pipeline(3);
+        std::vector<std::string> order;
+        pipeline.push_back(0, make_task([&]()
+        {
+            for (const auto i : algo::range(1, 4))
+            {
+                pipeline.push_front(1, make_task([&, i]()
+                {
+                    order.push_back(algo::format("run %d", i));
+                    return true;
+                }));
+                order.push_back(algo::format("push %d", i));
+            }
+            return true;
+        }));
+
+        SECTION("Disabled")
+        {
+            pipeline.set_throttle([]() { return false; });
+            pipeline.run(make_stages(1, 10), 1);
+            REQUIRE(order == (std::vector<std::string>{
+                "push 1", "push 2", "push 3", "run 3", "run 2", "run 1"}));
+        }
+
+        SECTION("Enabled")
+        {
+            pipeline.set_throttle([]() { return true; });
+            pipeline.run(make_stages(1, 10), 1);
+            REQUIRE(order == (std::vector<std::string>{
+                "push 1", "run 1", "push 2", "run 2", "push 3", "run 3"}));
+        }
+    }
+
+    SECTION("Tasks can go back to the earlier stages")
+    {
+        Pipeline pipeline(3);
+        std::atomic<int> executed_count(0);
+        std::function<void(int)> spawn = [&](const int depth)
+        {
+            pipeline.push_front(0, make_task([&, depth]()
+            {
+                for (const auto i : algo::range(3))
+                {
+                    pipeline.push_front(2, make_task([&, depth]()
+                    {
+                        ++executed_count;
+                        if (depth < 5)
+                            spawn(depth + 1);
+                        return true;
+                    }));
+                }
+                return true;
+            }));
+        };
+        spawn(0);
+        const auto result = pipeline.run(make_stages(2, 1), 2);
+        REQUIRE(executed_count == 3 + 9 + 27 + 81 + 243 + 729);
+        REQUIRE(result.error_count == 0);
+    }
+
+    SECTION("Tasks pushed by other tasks keep the workers running")
+    {
+        Pipeline pipeline(1);
+        std::atomic<int> executed_count(0);
+        std::function<void(int)> spawn = [&](const int depth)
+        {
+            pipeline.push_front(0, make_task([&, depth]()
+            {
+                ++executed_count;
+                if (depth < 10)
+                {
+                    spawn(depth + 1);
+                    spawn(depth + 1);
+                }
+                return true;
+            }));
+        };
+        spawn(0);
+        const auto result = pipeline.run({{"only", 8, 8}}, 8);
+        REQUIRE(executed_count == 2047);
+        REQUIRE(result.success_count == 2047);
+        REQUIRE(result.error_count == 0);
+    }
+
+    SECTION("Tasks use the threads of idle workers")
+    {
+        algo::set_thread_budget(4);
+        Pipeline pipeline(3);
+        std::mutex mutex;
+        std::set<std::thread::id> thread_ids;
+        pipeline.push_back(1, make_task([&]()
+        {
+            algo::parallel_for(100, [&](const size_t)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                thread_ids.insert(std::this_thread::get_id());
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+            return true;
+        }));
+        pipeline.run(make_stages(4, 4), 4);
+        algo::set_thread_budget(0);
+        REQUIRE(thread_ids.size() > 1);
+        REQUIRE(thread_ids.size() <= 4);
+    }
+
+    SECTION("Tasks stay within the thread budget")
+    {
+        algo::set_thread_budget(4);
+        Pipeline pipeline(3);
+        std::atomic<int> active_count(0);
+        std::atomic<int> max_active_count(0);
+        const auto enter = [&]()
+        {
+            const int current = ++active_count;
+            int max = max_active_count;
+            while (current > max
+                && !max_active_count.compare_exchange_weak(max, current))
+            {
+            }
+        };
+        for (const auto i : algo::range(8))
+        {
+            pipeline.push_back(1, make_task([&]()
+            {
+                enter();
+                const auto worker_id = std::this_thread::get_id();
+                algo::parallel_for(16, [&](const size_t)
+                {
+                    const auto is_worker
+                        = std::this_thread::get_id() == worker_id;
+                    if (!is_worker)
+                        enter();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    if (!is_worker)
+                        --active_count;
+                });
+                --active_count;
+                return true;
+            }));
+        }
+        pipeline.run(make_stages(4, 4), 4);
+        algo::set_thread_budget(0);
+        // workers don't wait for the threads lent to parallel_for
+        REQUIRE(max_active_count <= 4 + 4);
+    }
+}
@@ -0,0 +1,52 @@
+#include "flow/trace_recorder.h"
+#include <thread>
+#include "algo/str.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+TEST_CASE("Trace recorder", "[flow]")
+{
+    TraceRecorder trace;
+
+    SECTION("No events")
+    {
+        REQUIRE(trace.format_json()
+            == "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n]}\n");
+    }
+
+    SECTION("Events of multiple threads")
+    {
+        trace.begin("read", {{"path", "dir\\a\"b"}});
+        std::thread([&]()
+        {
+            trace.begin("decode", {});
+            trace.end("decode", {{"decoder", "fmt/arc"}});
+        }).join();
+        trace.end("read", {});
+
+        const auto lines = algo::split(trace.format_json(), '\n', false);
+        REQUIRE(lines.size() == 8);
+        REQUIRE(lines[1] ==
+            "  {\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, "
+            "\"tid\": 1, \"args\": {\"name\": \"thread 1\"}},");
+        REQUIRE(lines[2] ==
+            "  {\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, "
+            "\"tid\": 2, \"args\": {\"name\": \"thread 2\"}},");
+        REQUIRE(lines[3].find("{\"ph\": \"B\", \"name\": \"read\", "
+            "\"pid\": 1, \"tid\": 1, \"ts\": ") == 2);
+        REQUIRE(lines[3].find(
+            "\"args\": {\"path\": \"dir\\\\a\\\"b\"}},") != std::string::npos);
+        REQUIRE(lines[4].find("\"ph\": \"B\", \"name\": \"decode\", "
+            "\"pid\": 1, \"tid\": 2") != std::string::npos);
+        REQUIRE(lines[5].find("\"ph\": \"E\", \"name\": \"decode\", "
+            "\"pid\": 1, \"tid\": 2") != std::string::npos);
+        REQUIRE(lines[5].find("\"args\": {\"decoder\": \"fmt/arc\"}},")
+            != std::string::npos);
+        REQUIRE(lines[6].find("\"ph\": \"E\", \"name\": \"read\", "
+            "\"pid\": 1, \"tid\": 1") != std::string::npos);
+        REQUIRE(lines[6].find("\"args\": {}}") != std::string::npos);
+        REQUIRE(lines[7] == "]}");
+    }
+}
@@ -178,6 +178,36 @@ TEST_CASE("Recursive unpacking with nested archives", "[flow]")
     REQUIRE(saved_files[1]->stream.read_to_eof() == "decoded_image"_b);
 }
 
+TEST_CASE("Recursive unpacking with a memory budget", "[flow]")
+{
+    const auto registry = create_registry();
+    const auto big_content = bstr(200 * 1024, 'x');
+
+    const auto inner_arc_content = make_archive(
+        {
+            tests::stub_file("nested/image.rgb", "discard"_b),
+            tests::stub_file("nested/text.txt", big_content),
+        });
+
+    const auto outer_arc_content = make_archive(
+        {
+            tests::stub_file("inner.arc", inner_arc_content),
+        });
+
+    io::File dummy_file("outer.arc", outer_arc_content);
+
+    // everything goes over the budget, so the nested archive gets spilled
+    const auto saved_files
+        = tests::flow_unpack(*registry, true, dummy_file, 1);
+    REQUIRE(saved_files.size() == 2);
+    tests::compare_paths(
+        saved_files[0]->path, "outer.arc/inner.arc/nested/text.txt");
+    tests::compare_paths(
+        saved_files[1]->path, "outer.arc/inner.arc/nested/image.png");
+    REQUIRE(saved_files[0]->stream.read_to_eof() == big_content);
+    REQUIRE(saved_files[1]->stream.read_to_eof() == "decoded_image"_b);
+}
+
 TEST_CASE(
     "Non-recursive unpacking doesn't execute child decoders", "[flow]")
 {
@@ -0,0 +1,104 @@
+#include "flow/unpacking_stats.h"
+#include "algo/range.h"
+#include "algo/str.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+static StatsSample make_sample(
+    const int milliseconds,
+    const size_t bytes_in,
+    const size_t bytes_out,
+    const size_t allocated_bytes = 0)
+{
+    StatsSample sample;
+    sample.duration = std::chrono::milliseconds(milliseconds);
+    sample.bytes_in = bytes_in;
+    sample.bytes_out = bytes_out;
+    sample.allocations.allocation_count = allocated_bytes ? 2 : 0;
+    sample.allocations.allocated_bytes = allocated_bytes;
+    sample.allocations.live_bytes = allocated_bytes / 2;
+    sample.allocations.peak_live_bytes = allocated_bytes / 2;
+    return sample;
+}
+
+TEST_CASE("Unpacking statistics", "[flow]")
+{
+    UnpackingStats stats;
+
+    SECTION("No records")
+    {
+        REQUIRE(stats.format_json() == "[]\n");
+        REQUIRE(algo::split(stats.format_table(), '\n', false).size() == 1);
+    }
+
+    SECTION("Aggregating records")
+    {
+        for (const auto i : algo::range(1, 101))
+        {
+            stats.add(
+                "fmt/arc", StatsStage::ReadFile, make_sample(i, 0, 10, i));
+        }
+        stats.add("fmt/arc", StatsStage::ReadMeta, make_sample(2, 1000, 0));
+        stats.add("fmt/img", StatsStage::Encode, make_sample(10000, 5, 3));
+
+        const auto json = stats.format_json();
+        const auto lines = algo::split(json, '\n', false);
+        REQUIRE(lines.size() == 5);
+        REQUIRE(lines[0] == "[");
+        REQUIRE(lines[4] == "]");
+
+        // sorted by total time
+        REQUIRE(lines[1] ==
+            "  {\"decoder\": \"fmt/img\", \"stage\": \"encode\", "
+            "\"count\": 1, \"total_ms\": 10000.000, \"p50_ms\": 10000.000, "
+            "\"p90_ms\": 10000.000, \"p99_ms\": 10000.000, "
+            "\"max_ms\": 10000.000, \"bytes_in\": 5, \"bytes_out\": 3, "
+            "\"allocations\": 0, \"allocated_bytes\": 0, "
+            "\"peak_live_bytes\": 0},");
+        REQUIRE(lines[2] ==
+            "  {\"decoder\": \"fmt/arc\", \"stage\": \"read_file\", "
+            "\"count\": 100, \"total_ms\": 5050.000, \"p50_ms\": 51.000, "
+            "\"p90_ms\": 90.000, \"p99_ms\": 99.000, "
+            "\"max_ms\": 100.000, \"bytes_in\": 0, \"bytes_out\": 1000, "
+            "\"allocations\": 200, \"allocated_bytes\": 5050, "
+            "\"peak_live_bytes\": 50},");
+        REQUIRE(lines[3] ==
+            "  {\"decoder\": \"fmt/arc\", \"stage\": \"read_meta\", "
+            "\"count\": 1, \"total_ms\": 2.000, \"p50_ms\": 2.000, "
+            "\"p90_ms\": 2.000, \"p99_ms\": 2.000, "
+            "\"max_ms\": 2.000, \"bytes_in\": 1000, \"bytes_out\": 0, "
+            "\"allocations\": 0, \"allocated_bytes\": 0, "
+            "\"peak_live_bytes\": 0}");
+
+        const auto table = algo::split(stats.format_table(), '\n', false);
+        REQUIRE(table.size() == 4);
+        REQUIRE(table[1].find("fmt/img") == 0);
+        REQUIRE(table[2].find("read_file") != std::string::npos);
+        REQUIRE(table[2].find("1000 B") != std::string::npos);
+        REQUIRE(table[2].find("4.9 KiB") != std::string::npos);
+        REQUIRE(table[3].find("1000 B") != std::string::npos);
+    }
+
+    SECTION("Escaping decoder names")
+    {
+        stats.add("a\"b\\c", StatsStage::Save, make_sample(1, 0, 0));
+        REQUIRE(stats.format_json().find("\"decoder\": \"a\\\"b\\\\c\"")
+            != std::string::npos);
+    }
+
+    SECTION("Measurements")
+    {
+        StatsSample sample;
+        {
+            const StatsMeasurement measurement(&stats);
+            const auto data = std::make_unique<std::vector<u8>>(1000);
+            sample = measurement.finish(1, 2);
+        }
+        REQUIRE(sample.bytes_in == 1);
+        REQUIRE(sample.bytes_out == 2);
+        REQUIRE(sample.allocations.allocation_count == 2);
+        REQUIRE(sample.allocations.allocated_bytes >= 1000);
+    }
+}
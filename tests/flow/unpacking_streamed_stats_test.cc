@@ -0,0 +1,117 @@
+#include "dec/base_archive_decoder.h"
+#include "io/sub_stream.h"
+#include "test_support/catch.h"
+#include "test_support/flow_support.h"
+
+using namespace au;
+using namespace au::dec;
+
+namespace
+{
+    class TestArchiveDecoder final : public BaseArchiveDecoder
+    {
+    public:
+        std::vector<std::string> get_linked_formats() const override;
+
+    protected:
+        bool is_recognized_impl(io::File &input_file) const override;
+
+        std::unique_ptr<ArchiveMeta> read_meta_impl(
+            const Logger &logger,
+            io::File &input_file) const override;
+
+        std::unique_ptr<io::File> read_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const override;
+
+        std::unique_ptr<io::File> stream_file_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const ArchiveMeta &m,
+            const ArchiveEntry &e) const override;
+    };
+}
+
+std::vector<std::string> TestArchiveDecoder::get_linked_formats() const
+{
+    return {"test/archive"};
+}
+
+bool TestArchiveDecoder::is_recognized_impl(io::File &input_file) const
+{
+    return input_file.path.has_extension("archive");
+}
+
+std::unique_ptr<ArchiveMeta> TestArchiveDecoder::read_meta_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    auto meta = std::make_unique<ArchiveMeta>();
+    auto entry = std::make_unique<ArchiveEntry>();
+    entry->path = "entry.dat";
+    meta->entries.push_back(std::move(entry));
+    return meta;
+}
+
+std::unique_ptr<io::File> TestArchiveDecoder::read_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const ArchiveMeta &,
+    const ArchiveEntry &e) const
+{
+    return std::make_unique<io::File>(
+        e.path, input_file.stream.seek(0).read_to_eof());
+}
+
+std::unique_ptr<io::File> TestArchiveDecoder::stream_file_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const ArchiveMeta &,
+    const ArchiveEntry &e) const
+{
+    return std::make_unique<io::File>(
+        e.path,
+        std::make_unique<io::SubStream>(
+            input_file.stream, 0, input_file.stream.size()));
+}
+
+static bool has_row(
+    const flow::UnpackingStats &stats,
+    const std::string &decoder_name,
+    const std::string &stage_name)
+{
+    return stats.format_json().find(
+        "{\"decoder\": \"" + decoder_name + "\", "
+        "\"stage\": \"" + stage_name + "\"") != std::string::npos;
+}
+
+TEST_CASE("Reading streamed entries is accounted for", "[flow]")
+{
+    auto registry = Registry::create_mock();
+    registry->add_decoder(
+        "test/archive",
+        []() { return std::make_shared<TestArchiveDecoder>(); });
+    io::File input_file("test.archive", "whatever"_b);
+    flow::UnpackingStats stats;
+
+    SECTION("Entries saved right away")
+    {
+        const auto saved_files = tests::flow_unpack(
+            *registry, false, input_file, 0, &stats);
+        REQUIRE(saved_files.size() == 1);
+        REQUIRE(saved_files[0]->stream.read_to_eof() == "whatever"_b);
+        REQUIRE(has_row(stats, "test/archive", "read_file+save"));
+        REQUIRE(!has_row(stats, "test/archive", "read_file"));
+    }
+
+    SECTION("Entries passed to nested decoding")
+    {
+        const auto saved_files = tests::flow_unpack(
+            *registry, true, input_file, 0, &stats);
+        REQUIRE(saved_files.size() == 1);
+        REQUIRE(saved_files[0]->stream.read_to_eof() == "whatever"_b);
+        REQUIRE(has_row(stats, "test/archive", "read_file"));
+        REQUIRE(!has_row(stats, "test/archive", "read_file+save"));
+    }
+}
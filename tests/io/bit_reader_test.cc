@@ -0,0 +1,115 @@
+#include "io/bit_reader.h"
+#include "algo/range.h"
+#include "io/lsb_bit_stream.h"
+#include "io/memory_stream.h"
+#include "io/msb_bit_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::io;
+
+static bstr make_input(const size_t size)
+{
+    bstr output(size);
+    u32 seed = 0x12345678;
+    for (const auto i : algo::range(size))
+    {
+        seed = seed * 1103515245 + 12345;
+        output[i] = seed >> 16;
+    }
+    return output;
+}
+
+// byte stream based bit streams fetch the input a byte at a time, which
+// makes them a good reference for the word refills
+template<BitOrder order, typename T> static void test_against_bit_stream()
+{
+    SECTION("Reading with mixed widths")
+    {
+        const auto input = make_input(1000);
+        BitReader<order> reader(input.get<u8>(), input.size());
+        MemoryStream byte_stream(input);
+        T bit_stream(byte_stream);
+        size_t width = 0;
+        while (true)
+        {
+            width = (width * 7 + 3) % 33;
+            if (reader.left() < width)
+                break;
+            INFO("Position: " << reader.tell() << ", width: " << width);
+            REQUIRE(reader.read(width) == bit_stream.read(width));
+            REQUIRE(reader.tell() == bit_stream.tell());
+        }
+    }
+
+    SECTION("Seeking")
+    {
+        const auto input = make_input(100);
+        BitReader<order> reader(input.get<u8>(), input.size());
+        MemoryStream byte_stream(input);
+        T bit_stream(byte_stream);
+        for (const size_t pos : {0, 1, 7, 8, 9, 63, 64, 65, 300, 767})
+        {
+            reader.seek(pos);
+            bit_stream.seek(pos);
+            REQUIRE(reader.tell() == pos);
+            REQUIRE(reader.read(32) == bit_stream.read(32));
+        }
+    }
+}
+
+TEST_CASE("BitReader", "[io]")
+{
+    SECTION("MSB order")
+    {
+        test_against_bit_stream<BitOrder::Msb, MsbBitStream>();
+    }
+
+    SECTION("LSB order")
+    {
+        test_against_bit_stream<BitOrder::Lsb, LsbBitStream>();
+    }
+
+    SECTION("Peeking and consuming")
+    {
+        const auto input = "\xC5\x3A"_b; // 11000101 00111010
+        BitReader<BitOrder::Msb> reader(input.get<u8>(), input.size());
+        reader.refill();
+        REQUIRE(reader.available() == 16);
+        REQUIRE(reader.peek(0) == 0);
+        REQUIRE(reader.peek(3) == 0b110);
+        REQUIRE(reader.peek(3) == 0b110);
+        reader.consume(3);
+        REQUIRE(reader.peek(7) == 0b0010100);
+        reader.consume(7);
+        REQUIRE(reader.tell() == 10);
+        // bits past the end read as zeros
+        REQUIRE(reader.peek(10) == 0b1110100000);
+        REQUIRE_THROWS(reader.consume(7));
+        reader.consume(6);
+        REQUIRE(reader.eof());
+    }
+
+    SECTION("Reading beyond EOF retains the position")
+    {
+        const auto input = make_input(11);
+        BitReader<BitOrder::Lsb> reader(input.get<u8>(), input.size());
+        reader.read(30);
+        reader.read(30);
+        REQUIRE_THROWS(reader.read(29));
+        REQUIRE(reader.tell() == 60);
+        REQUIRE(reader.left() == 28);
+        reader.read(28);
+        REQUIRE(reader.eof());
+        REQUIRE_THROWS(reader.read(1));
+        REQUIRE_THROWS(reader.seek(89));
+    }
+
+    SECTION("Empty input")
+    {
+        BitReader<BitOrder::Msb> reader;
+        REQUIRE(reader.eof());
+        REQUIRE(reader.read(0) == 0);
+        REQUIRE_THROWS(reader.read(1));
+    }
+}
@@ -0,0 +1,64 @@
+#include "io/file_stream.h"
+#include "io/file_system.h"
+#include "io/mapped_file_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("MappedFileStream", "[io][stream]")
+{
+    SECTION("Reading from existing files")
+    {
+        static const bstr png_magic = "\x89PNG"_b;
+        const io::path path = "tests/dec/png/files/reimu_transparent.png";
+        io::MappedFileStream stream(path);
+        REQUIRE(stream.read(png_magic.size()) == png_magic);
+        REQUIRE(stream.size()
+            == io::FileStream(path, io::FileMode::Read).size());
+        REQUIRE_THROWS(stream.seek(stream.size() + 1));
+    }
+
+    SECTION("Reading from empty files")
+    {
+        {
+            io::FileStream stream("tests/trash.out", io::FileMode::Write);
+        }
+        {
+            io::MappedFileStream stream("tests/trash.out");
+            REQUIRE(stream.size() == 0);
+            REQUIRE(stream.eof());
+            REQUIRE_THROWS(stream.read<u8>());
+        }
+        io::remove("tests/trash.out");
+    }
+
+    SECTION("Reading from missing files")
+    {
+        REQUIRE_THROWS(io::MappedFileStream("tests/nonexistent.out"));
+    }
+
+    SECTION("Cloning")
+    {
+        io::MappedFileStream stream("tests/io/mapped_file_stream_test.cc");
+        stream.seek(1);
+        const auto clone = stream.clone();
+        REQUIRE(clone->tell() == 1);
+        REQUIRE(clone->size() == stream.size());
+        REQUIRE(clone->read_to_eof() == stream.read_to_eof());
+    }
+
+    SECTION("Reading slices")
+    {
+        io::MappedFileStream stream("tests/io/mapped_file_stream_test.cc");
+        const auto slice = stream.seek(1).read_slice(10);
+        REQUIRE(stream.tell() == 11);
+        REQUIRE(slice == stream.seek(1).read(10));
+        REQUIRE_THROWS(stream.read_slice(stream.size()));
+    }
+
+    SECTION("Writing")
+    {
+        io::MappedFileStream stream("tests/io/mapped_file_stream_test.cc");
+        REQUIRE_THROWS(stream.write("x"_b));
+    }
+}
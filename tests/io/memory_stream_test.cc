@@ -12,4 +12,35 @@ TEST_CASE("MemoryStream", "[io][stream]")
             []() { return std::make_unique<io::MemoryStream>(); },
             []() { });
     }
+
+    SECTION("Wrapping slices")
+    {
+        const bslice slice("abcdef"_b);
+        io::MemoryStream stream(slice);
+        REQUIRE(stream.size() == 6);
+
+        SECTION("Reading slices doesn't copy the data")
+        {
+            stream.seek(1);
+            const auto sub_slice = stream.read_slice(2);
+            REQUIRE(sub_slice == "bc"_b);
+            REQUIRE(sub_slice.get<u8>() == slice.get<u8>() + 1);
+            REQUIRE(stream.tell() == 3);
+            REQUIRE_THROWS(stream.read_slice(4));
+        }
+
+        SECTION("Writing doesn't affect the slice")
+        {
+            stream.seek(1).write("x"_b);
+            REQUIRE(stream.seek(0).read_to_eof() == "axcdef"_b);
+            REQUIRE(slice == "abcdef"_b);
+        }
+
+        SECTION("Nested streams")
+        {
+            io::MemoryStream other_stream(stream.seek(2), 3);
+            REQUIRE(other_stream.read_to_eof() == "cde"_b);
+            REQUIRE(stream.tell() == 5);
+        }
+    }
 }
@@ -0,0 +1,51 @@
+#include "io/memory_stream.h"
+#include "io/sub_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("SubStream", "[io][stream]")
+{
+    io::MemoryStream parent_stream("abcdefgh"_b);
+    parent_stream.seek(1);
+
+    SECTION("Reading")
+    {
+        io::SubStream stream(parent_stream, 2, 4);
+        REQUIRE(stream.size() == 4);
+        REQUIRE(stream.read(2) == "cd"_b);
+        REQUIRE(stream.read_to_eof() == "ef"_b);
+        REQUIRE(stream.eof());
+        REQUIRE_THROWS(stream.read(1));
+        REQUIRE(parent_stream.tell() == 1);
+    }
+
+    SECTION("Seeking")
+    {
+        io::SubStream stream(parent_stream, 2, 4);
+        REQUIRE(stream.seek(3).read(1) == "f"_b);
+        REQUIRE(stream.seek(0).read(1) == "c"_b);
+        REQUIRE_THROWS(stream.seek(5));
+    }
+
+    SECTION("Cloning")
+    {
+        io::SubStream stream(parent_stream, 2, 4);
+        stream.seek(1);
+        const auto clone = stream.clone();
+        REQUIRE(clone->tell() == 1);
+        REQUIRE(clone->read_to_eof() == "def"_b);
+        REQUIRE(stream.read_to_eof() == "def"_b);
+    }
+
+    SECTION("Ranges beyond parent stream")
+    {
+        REQUIRE_THROWS(io::SubStream(parent_stream, 6, 3));
+    }
+
+    SECTION("Writing")
+    {
+        io::SubStream stream(parent_stream, 2, 4);
+        REQUIRE_THROWS(stream.write("x"_b));
+    }
+}
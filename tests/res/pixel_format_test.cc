@@ -1,4 +1,5 @@
 #include "res/pixel_format.h"
+#include "res/pixel_format_simd.h"
 #include "algo/format.h"
 #include "algo/range.h"
 #include "test_support/catch.h"
@@ -32,6 +33,45 @@ static void test_read(
     compare_pixels(actual_pixel, expected_pixel);
 }
 
+// a single pixel is too few for the vector kernels, so this takes the
+// scalar path
+static res::Pixel read_scalar(const u8 *input_ptr, const res::PixelFormat fmt)
+{
+    std::vector<res::Pixel> pixels(1);
+    res::read_pixels(input_ptr, pixels, fmt);
+    return pixels[0];
+}
+
+static void test_simd_read(
+    const res::PixelFormat fmt, const res::SimdLevel level, const size_t count)
+{
+    const auto bpp = res::pixel_format_to_bpp(fmt);
+    bstr input(count * bpp);
+    u32 seed = 0x12345678;
+    for (auto &c : input)
+    {
+        seed = seed * 1103515245 + 12345;
+        c = seed >> 16;
+    }
+
+    // the pixels past the count must stay untouched
+    const res::Pixel guard = {1, 2, 3, 4};
+    std::vector<res::Pixel> actual_pixels(count + 16, guard);
+    const auto done = res::read_pixels_simd(
+        input.get<u8>(), actual_pixels.data(), count, fmt, level);
+    REQUIRE(done <= count);
+    if (level == res::SimdLevel::Avx2 && count >= 16)
+        REQUIRE(done > 0);
+    for (const auto i : algo::range(done))
+    {
+        INFO("Pixel: " << i);
+        compare_pixels(
+            actual_pixels[i], read_scalar(input.get<u8>() + i * bpp, fmt));
+    }
+    for (const auto i : algo::range(done, actual_pixels.size()))
+        compare_pixels(actual_pixels[i], guard);
+}
+
 TEST_CASE("PixelFormat", "[res]")
 {
     SECTION("Pixel format count")
@@ -109,4 +149,22 @@ TEST_CASE("PixelFormat", "[res]")
         test_read(
             0b11111110000000010000001000000011, PF::RGBnA8888, {1, 2, 3, 1});
     }
+
+    SECTION("Vector kernels match the scalar code")
+    {
+        const auto max_level = static_cast<int>(res::get_simd_level());
+        const auto format_count = static_cast<int>(res::PixelFormat::Count);
+        for (const auto level : algo::range(max_level + 1))
+        for (const auto fmt : algo::range(format_count))
+        for (const auto count : {0, 7, 37, 1000})
+        {
+            INFO("Level: " << level);
+            INFO("Format: " << fmt);
+            INFO("Count: " << count);
+            test_simd_read(
+                static_cast<res::PixelFormat>(fmt),
+                static_cast<res::SimdLevel>(level),
+                count);
+        }
+    }
 }
@@ -23,8 +23,17 @@ std::vector<std::shared_ptr<io::File>> tests::unpack(
     std::vector<std::shared_ptr<io::File>> files;
     for (const auto &entry : meta->entries)
     {
-        files.push_back(decoder.read_file(
-            dummy_logger, input_file, *meta, *entry));
+        auto file = decoder.read_file(dummy_logger, input_file, *meta, *entry);
+
+        // streaming the entry must yield the same content as reading it
+        const auto streamed_file = decoder.stream_file(
+            dummy_logger, input_file, *meta, *entry);
+        REQUIRE(streamed_file->path == file->path);
+        REQUIRE(streamed_file->stream.seek(0).read_to_eof()
+            == file->stream.seek(0).read_to_eof());
+        file->stream.seek(0);
+
+        files.push_back(std::move(file));
     }
     return files;
 }
@@ -1,4 +1,5 @@
 #include "test_support/flow_support.h"
+#include "enc/png/png_image_encoder.h"
 #include "flow/file_saver_callback.h"
 #include "flow/parallel_unpacker.h"
 
@@ -7,7 +8,9 @@ using namespace au;
 std::vector<std::shared_ptr<io::File>> tests::flow_unpack(
     const dec::Registry &registry,
     const bool enable_nested_decoding,
-    io::File &input_file)
+    io::File &input_file,
+    const size_t max_memory,
+    flow::UnpackingStats *stats)
 {
     Logger dummy_logger;
     dummy_logger.mute();
@@ -21,13 +24,17 @@ std::vector<std::shared_ptr<io::File>> tests::flow_unpack(
         });
 
     const auto name_list = registry.get_decoder_names();
+    const enc::png::PngImageEncoder image_encoder;
     flow::ParallelUnpackerContext context(
         dummy_logger,
         file_saver,
         registry,
         enable_nested_decoding,
         {},
-        std::set<std::string>(name_list.begin(), name_list.end()));
+        std::set<std::string>(name_list.begin(), name_list.end()),
+        image_encoder,
+        max_memory,
+        stats);
 
     flow::ParallelUnpacker unpacker(context);
     unpacker.add_input_file(
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dec/registry.h"
+#include "flow/unpacking_stats.h"
 #include "io/file.h"
 
 namespace au {
@@ -9,6 +10,8 @@ namespace tests {
     std::vector<std::shared_ptr<io::File>> flow_unpack(
         const dec::Registry &registry,
         const bool enable_ensted_decoding,
-        io::File &input_file);
+        io::File &input_file,
+        const size_t max_memory = 0,
+        flow::UnpackingStats *stats = nullptr);
 
 } }
@@ -335,3 +335,67 @@ TEST_CASE("bstr", "[core][types]")
         }
     }
 }
+
+TEST_CASE("bslice", "[core][types]")
+{
+    SECTION("Constructors")
+    {
+        SECTION("Empty")
+        {
+            const bslice x;
+            REQUIRE(x.empty());
+            REQUIRE(x.size() == 0);
+            REQUIRE(x == ""_b);
+        }
+
+        SECTION("Copying from bstr")
+        {
+            bstr input = "abc"_b;
+            const bslice x(input);
+            input[0] = 'x';
+            REQUIRE(x == "abc"_b);
+        }
+
+        SECTION("Taking over bstr")
+        {
+            bstr input = "abc"_b;
+            const auto ptr = input.get<const u8>();
+            const bslice x(std::move(input));
+            REQUIRE(x == "abc"_b);
+            REQUIRE(x.get<u8>() == ptr);
+        }
+    }
+
+    SECTION("Converting to bstr")
+    {
+        const bslice x("abc"_b);
+        REQUIRE(bstr(x) == "abc"_b);
+    }
+
+    SECTION("Extracting substrings")
+    {
+        const bslice x("abcdef"_b);
+        REQUIRE(x.substr(2) == "cdef"_b);
+        REQUIRE(x.substr(2, 3) == "cde"_b);
+        REQUIRE(x.substr(2, 30) == "cdef"_b);
+        REQUIRE(x.substr(30) == ""_b);
+        REQUIRE(x.substr(2, 3).get<u8>() == x.get<u8>() + 2);
+    }
+
+    SECTION("Substrings outlive the original slice")
+    {
+        bslice y;
+        {
+            const bslice x("abcdef"_b);
+            y = x.substr(1, 2);
+        }
+        REQUIRE(y == "bc"_b);
+    }
+
+    SECTION("Accessing individual characters")
+    {
+        const bslice x("abc"_b);
+        REQUIRE(x[1] == 'b');
+        REQUIRE(x.end() - x.begin() == 3);
+    }
+}
@@ -0,0 +1,115 @@
+#include "virtual_file_system.h"
+#include "io/file_stream.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static std::function<std::unique_ptr<io::File>()> make_factory(
+    const io::path &path, const bstr &content)
+{
+    return [=]() { return std::make_unique<io::File>(path, content); };
+}
+
+static bstr read(const std::unique_ptr<io::File> &file)
+{
+    REQUIRE(file);
+    return file->stream.seek(0).read_to_eof();
+}
+
+TEST_CASE("VirtualFileSystem", "[core]")
+{
+    SECTION("Registered files")
+    {
+        VirtualFileSystem::register_file(
+            "dir/Test.dat", make_factory("dir/Test.dat", "1"_b));
+        REQUIRE(read(VirtualFileSystem::get_by_stem("test")) == "1"_b);
+        REQUIRE(read(VirtualFileSystem::get_by_name("TEST.DAT")) == "1"_b);
+        REQUIRE(read(VirtualFileSystem::get_by_path("dir/test.dat")) == "1"_b);
+        REQUIRE(!VirtualFileSystem::get_by_name("test.bin"));
+        REQUIRE(!VirtualFileSystem::get_by_path("test.dat"));
+
+        VirtualFileSystem::unregister_file("dir/Test.dat");
+        REQUIRE(!VirtualFileSystem::get_by_stem("test"));
+        REQUIRE(!VirtualFileSystem::get_by_name("test.dat"));
+        REQUIRE(!VirtualFileSystem::get_by_path("dir/test.dat"));
+    }
+
+    SECTION("Files sharing the same stem")
+    {
+        VirtualFileSystem::register_file(
+            "b/test.dat", make_factory("b/test.dat", "2"_b));
+        VirtualFileSystem::register_file(
+            "a/test.bin", make_factory("a/test.bin", "1"_b));
+        REQUIRE(read(VirtualFileSystem::get_by_stem("test")) == "1"_b);
+        VirtualFileSystem::unregister_file("a/test.bin");
+        REQUIRE(read(VirtualFileSystem::get_by_stem("test")) == "2"_b);
+        VirtualFileSystem::unregister_file("b/test.dat");
+        REQUIRE(!VirtualFileSystem::get_by_stem("test"));
+    }
+
+    SECTION("Registered directories")
+    {
+        const io::path dir = "test-vfs-dir";
+        io::create_directories(dir / "nested");
+        {
+            io::FileStream stream(
+                dir / "nested" / "Test.dat", io::FileMode::Write);
+            stream.write("1"_b);
+        }
+        VirtualFileSystem::register_directory(dir);
+        try
+        {
+            REQUIRE(read(VirtualFileSystem::get_by_stem("test")) == "1"_b);
+            REQUIRE(read(VirtualFileSystem::get_by_name("test.DAT")) == "1"_b);
+            REQUIRE(read(VirtualFileSystem::get_by_path(
+                dir / "nested" / "TEST.dat")) == "1"_b);
+            REQUIRE(!VirtualFileSystem::get_by_name("test.bin"));
+        }
+        catch (...)
+        {
+            VirtualFileSystem::unregister_directory(dir);
+            boost::filesystem::remove_all(dir.str());
+            throw;
+        }
+        VirtualFileSystem::unregister_directory(dir);
+        boost::filesystem::remove_all(dir.str());
+        REQUIRE(!VirtualFileSystem::get_by_stem("test"));
+    }
+
+    SECTION("Registering directories again")
+    {
+        const io::path dir = "test-vfs-dir";
+        io::create_directories(dir);
+        VirtualFileSystem::register_directory(dir);
+        try
+        {
+            REQUIRE(!VirtualFileSystem::get_by_name("test.dat"));
+            {
+                io::FileStream stream(dir / "test.dat", io::FileMode::Write);
+                stream.write("1"_b);
+            }
+            VirtualFileSystem::register_directory(dir);
+            REQUIRE(read(VirtualFileSystem::get_by_name("test.dat")) == "1"_b);
+        }
+        catch (...)
+        {
+            VirtualFileSystem::unregister_directory(dir);
+            boost::filesystem::remove_all(dir.str());
+            throw;
+        }
+        VirtualFileSystem::unregister_directory(dir);
+        boost::filesystem::remove_all(dir.str());
+    }
+
+    SECTION("Disabling")
+    {
+        VirtualFileSystem::register_file(
+            "test.dat", make_factory("test.dat", "1"_b));
+        VirtualFileSystem::disable();
+        REQUIRE(!VirtualFileSystem::get_by_stem("test"));
+        VirtualFileSystem::enable();
+        REQUIRE(read(VirtualFileSystem::get_by_stem("test")) == "1"_b);
+        VirtualFileSystem::unregister_file("test.dat");
+    }
+}